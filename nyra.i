@@ -5,6 +5,10 @@
     #include "nyra/SwigActor.h"
     #include "nyra/SwigEngine.h"
     #include "nyra/InputConstants.h"
+    #include "nyra/ProfileStats.h"
+    #include "nyra/PhysicsSettings.h"
+    #include "nyra/PhysicsStats.h"
+    #include "nyra/PhysicsHits.h"
 %}
 
 %include "exception.i"
@@ -31,9 +35,15 @@
 %include "nyra/SwigActor.h"
 %include "nyra/SwigEngine.h"
 %include "nyra/InputConstants.h"
+%include "nyra/ProfileStats.h"
+%include "nyra/PhysicsSettings.h"
+%include "nyra/PhysicsStats.h"
+%include "nyra/PhysicsHits.h"
 
 %template(Vector2) nyra::Vector2Impl<float>;
 %template(SizeTVector) std::vector<size_t>;
+%template(StringVector) std::vector<std::string>;
+%template(DoubleVector) std::vector<double>;
 
 %pythoncode
 %{
@@ -53,6 +63,9 @@ def set_position(self, values):
 def apply_force(self, force):
     self._apply_force(nyra.Vector2(force[0], force[1]))
 
+def attach(self, parent, offset=(0, 0), rotation=0.0):
+    self._attach(parent, nyra.Vector2(offset[0], offset[1]), rotation)
+
 def register_input(name, values):
     inputs = SizeTVector()
     if type(values) == int:
@@ -62,6 +75,113 @@ def register_input(name, values):
             inputs.push_back(val)
     nyra._register_input(name, inputs)
 
+def spawn(name, position):
+    actor = Actor()
+    actor._set_data(nyra._spawn(name,
+                                nyra.Vector2(position[0], position[1])))
+    return actor
+
+class Query:
+    def __init__(self, components=(), tags=()):
+        self._index = nyra._add_query(list(components), list(tags))
+
+    def handles(self):
+        return nyra._query_results(self._index)
+
+    def __len__(self):
+        return nyra._query_size(self._index)
+
+    def __iter__(self):
+        for handle in nyra._query_results(self._index):
+            actor = Actor()
+            actor._set_data(handle)
+            yield actor
+
+def _event_source(source):
+    return source._get_data() if source else 0
+
+def post_event(name, target, source=None, value=0.0, position=(0, 0)):
+    nyra._post_event(name, target._get_data(), _event_source(source),
+                     value, nyra.Vector2(position[0], position[1]))
+
+def broadcast_event(name, query, source=None, value=0.0, position=(0, 0)):
+    nyra._broadcast_event(name, query._index, _event_source(source),
+                          value, nyra.Vector2(position[0], position[1]))
+
+# Positions may be (x, y) pairs or a flat list of x and y values
+def spawn_many(name, positions, rotations=()):
+    positions = list(positions)
+    if positions and not isinstance(positions[0], (int, long, float)):
+        positions = [value for position in positions for value in position]
+    return nyra._spawn_many(name, positions, list(rotations))
+
+def _to_actor(handle):
+    if not handle:
+        return None
+    actor = Actor()
+    actor._set_data(handle)
+    return actor
+
+# Each hit is None or (actor, point, normal, fraction). The actor is None
+# for bodies without one, such as merged map tiles.
+def _to_hits(results):
+    actors = list(results.actors)
+    values = list(results.values)
+    hits = []
+    for ii, handle in enumerate(actors):
+        offset = ii * 5
+        if values[offset + 4] < 0.0:
+            hits.append(None)
+        else:
+            hits.append((_to_actor(handle),
+                         (values[offset], values[offset + 1]),
+                         (values[offset + 2], values[offset + 3]),
+                         values[offset + 4]))
+    return hits
+
+# Rays are (start, end) pairs of points
+def ray_cast_many(rays):
+    coordinates = [value for ray in rays for point in ray for value in point]
+    return _to_hits(nyra._ray_cast_many(coordinates))
+
+def ray_cast(start, end):
+    return ray_cast_many(((start, end),))[0]
+
+# Casts are (start, end, radius) tuples
+def circle_cast_many(casts):
+    coordinates = []
+    radii = []
+    for start, end, radius in casts:
+        coordinates.extend((start[0], start[1], end[0], end[1]))
+        radii.append(radius)
+    return _to_hits(nyra._circle_cast_many(coordinates, radii))
+
+def circle_cast(start, end, radius):
+    return circle_cast_many(((start, end, radius),))[0]
+
+# Boxes are (top left, bottom right) pairs of points
+def query_box_many(boxes):
+    coordinates = [value for box in boxes for point in box for value in point]
+    results = nyra._query_box_many(coordinates)
+    actors = [_to_actor(handle) for handle in results.actors]
+    offsets = list(results.offsets)
+    return [actors[offsets[ii]:offsets[ii + 1]]
+            for ii in range(len(offsets) - 1)]
+
+def query_box(lower, upper):
+    return query_box_many(((lower, upper),))[0]
+
+def profile_stats(phase):
+    stats = nyra._profile_stats(phase)
+    return {'count': stats.count,
+            'min': stats.minimum,
+            'avg': stats.average,
+            'max': stats.maximum,
+            'p99': stats.p99}
+
+def profile_phases():
+    return list(nyra._profile_phases())
+
 class Camera:
     @staticmethod
     def track(actor, offset=(0, 0)):
@@ -72,5 +192,6 @@ Actor.position = property(get_position)
 Actor.position = Actor.position.setter(set_position)
 Actor.velocity = property(get_velocity)
 Actor.apply_force = apply_force
+Actor.attach = attach
 %}
 
@@ -0,0 +1,319 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <dirent.h>
+#include <SFML/Graphics.hpp>
+#include <nyra/Logger.h>
+
+namespace
+{
+//===========================================================================//
+struct Options
+{
+    Options() :
+        pageSize(2048),
+        maxSize(256),
+        padding(1),
+        output("atlas")
+    {
+    }
+
+    std::string directory;
+    unsigned int pageSize;
+    unsigned int maxSize;
+    unsigned int padding;
+    std::string output;
+};
+
+//===========================================================================//
+struct Image
+{
+    std::string filename;
+    sf::Image image;
+    size_t page;
+    sf::Vector2u position;
+};
+
+//===========================================================================//
+void usage()
+{
+    std::cout <<
+        "Usage: atlas [options] <texture directory>\n"
+        "  --page-size <n>    Width and height of each page in pixels\n"
+        "  --max-size <n>     Images larger than this are not packed\n"
+        "  --padding <n>      Empty pixels between packed images\n"
+        "  --output <name>    Name of the atlas json and page images\n";
+}
+
+//===========================================================================//
+Options parseOptions(int argc, char** argv)
+{
+    Options options;
+    for (int ii = 1; ii < argc; ++ii)
+    {
+        const std::string arg(argv[ii]);
+        const bool hasValue = ii + 1 < argc;
+        if (arg == "--page-size" && hasValue)
+        {
+            options.pageSize = std::stoul(argv[++ii]);
+        }
+        else if (arg == "--max-size" && hasValue)
+        {
+            options.maxSize = std::stoul(argv[++ii]);
+        }
+        else if (arg == "--padding" && hasValue)
+        {
+            options.padding = std::stoul(argv[++ii]);
+        }
+        else if (arg == "--output" && hasValue)
+        {
+            options.output = argv[++ii];
+        }
+        else if (options.directory.empty() && arg.compare(0, 2, "--") != 0)
+        {
+            options.directory = arg;
+        }
+        else
+        {
+            usage();
+            throw std::runtime_error("Invalid argument: " + arg);
+        }
+    }
+
+    if (options.directory.empty())
+    {
+        usage();
+        throw std::runtime_error("No texture directory was given");
+    }
+    if (options.maxSize > options.pageSize)
+    {
+        options.maxSize = options.pageSize;
+    }
+    return options;
+}
+
+//===========================================================================//
+bool endsWith(const std::string& value, const std::string& suffix)
+{
+    return value.size() >= suffix.size() &&
+           value.compare(value.size() - suffix.size(),
+                         suffix.size(), suffix) == 0;
+}
+
+//===========================================================================//
+std::vector<Image> readImages(const Options& options)
+{
+    DIR* dir = opendir(options.directory.c_str());
+    if (!dir)
+    {
+        throw std::runtime_error(
+                "Unable to open directory: " + options.directory);
+    }
+
+    std::vector<std::string> filenames;
+    while (const dirent* entry = readdir(dir))
+    {
+        const std::string filename(entry->d_name);
+
+        // Skip pages from a previous run
+        if (endsWith(filename, ".png") &&
+            filename.compare(0, options.output.size() + 1,
+                             options.output + "_") != 0)
+        {
+            filenames.push_back(filename);
+        }
+    }
+    closedir(dir);
+    std::sort(filenames.begin(), filenames.end());
+
+    std::vector<Image> images;
+    for (const std::string& filename : filenames)
+    {
+        Image image;
+        image.filename = filename;
+        if (!image.image.loadFromFile(options.directory + "/" + filename))
+        {
+            throw std::runtime_error("Unable to load image: " + filename);
+        }
+
+        const sf::Vector2u size = image.image.getSize();
+        if (size.x > options.maxSize || size.y > options.maxSize)
+        {
+            nyra::Logger::info("Skipping large image: " + filename);
+            continue;
+        }
+        images.push_back(image);
+    }
+    return images;
+}
+
+//===========================================================================//
+bool tallerThan(const Image& lhs, const Image& rhs)
+{
+    const sf::Vector2u lhsSize = lhs.image.getSize();
+    const sf::Vector2u rhsSize = rhs.image.getSize();
+    if (lhsSize.y != rhsSize.y)
+    {
+        return lhsSize.y > rhsSize.y;
+    }
+    return lhsSize.x > rhsSize.x;
+}
+
+//===========================================================================//
+std::vector<sf::Vector2u> pack(std::vector<Image>& images,
+                               const Options& options)
+{
+    // Shelf packing. Images are sorted tallest first and placed left to
+    // right. When a row is full a new row starts below the tallest image
+    // in it and when a page is full a new page is started.
+    std::sort(images.begin(), images.end(), tallerThan);
+
+    std::vector<sf::Vector2u> pages;
+    sf::Vector2u cursor(0, 0);
+    unsigned int shelfHeight = 0;
+    for (Image& image : images)
+    {
+        const sf::Vector2u size = image.image.getSize();
+        if (cursor.x + size.x > options.pageSize)
+        {
+            cursor.x = 0;
+            cursor.y += shelfHeight + options.padding;
+            shelfHeight = 0;
+        }
+        if (pages.empty() || cursor.y + size.y > options.pageSize)
+        {
+            pages.push_back(sf::Vector2u(0, 0));
+            cursor = sf::Vector2u(0, 0);
+            shelfHeight = 0;
+        }
+
+        image.page = pages.size() - 1;
+        image.position = cursor;
+
+        sf::Vector2u& used = pages.back();
+        used.x = std::max(used.x, cursor.x + size.x);
+        used.y = std::max(used.y, cursor.y + size.y);
+        shelfHeight = std::max(shelfHeight, size.y);
+        cursor.x += size.x + options.padding;
+    }
+    return pages;
+}
+
+//===========================================================================//
+std::string toJSON(unsigned int value)
+{
+    // JSONNode only accepts numbers written as doubles
+    return std::to_string(value) + ".0";
+}
+
+//===========================================================================//
+void writeAtlas(const std::vector<Image>& images,
+                const std::vector<sf::Vector2u>& pages,
+                const Options& options)
+{
+    std::stringstream json;
+    json << "{\n    \"pages\": [";
+    for (size_t page = 0; page < pages.size(); ++page)
+    {
+        const std::string filename =
+                options.output + "_" + std::to_string(page) + ".png";
+
+        sf::Image pageImage;
+        pageImage.create(pages[page].x, pages[page].y, sf::Color::Transparent);
+
+        json << (page ? "," : "") << "\n        {\"filename\": \""
+             << filename << "\", \"textures\": [";
+        bool first = true;
+        for (const Image& image : images)
+        {
+            if (image.page != page)
+            {
+                continue;
+            }
+
+            pageImage.copy(image.image, image.position.x, image.position.y);
+
+            const sf::Vector2u size = image.image.getSize();
+            json << (first ? "" : ",") << "\n            {\"filename\": \""
+                 << image.filename << "\", \"position\": {\"x\": "
+                 << toJSON(image.position.x) << ", \"y\": "
+                 << toJSON(image.position.y) << "}, \"size\": {\"x\": "
+                 << toJSON(size.x) << ", \"y\": " << toJSON(size.y) << "}}";
+            first = false;
+        }
+        json << "\n        ]}";
+
+        const std::string pathname = options.directory + "/" + filename;
+        if (!pageImage.saveToFile(pathname))
+        {
+            throw std::runtime_error("Unable to write page: " + pathname);
+        }
+    }
+    json << "\n    ]\n}\n";
+
+    const std::string pathname =
+            options.directory + "/" + options.output + ".json";
+    std::ofstream file(pathname);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Unable to write file: " + pathname);
+    }
+    file << json.str();
+}
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        nyra::Logger::registerLogger(nyra::Logger::INFO, "./atlas_log.txt");
+        const Options options = parseOptions(argc, argv);
+
+        std::vector<Image> images = readImages(options);
+        const std::vector<sf::Vector2u> pages = pack(images, options);
+        writeAtlas(images, pages, options);
+
+        nyra::Logger::info("Packed " + std::to_string(images.size()) +
+                           " images into " + std::to_string(pages.size()) +
+                           " pages");
+        return 0;
+    }
+    catch (const std::exception& ex)
+    {
+        nyra::Logger::error(
+                std::string("Caught standard exception: ") + ex.what());
+    }
+    catch (...)
+    {
+        nyra::Logger::error("Caught unnamed exception");
+    }
+
+    return 1;
+}
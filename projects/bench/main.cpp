@@ -0,0 +1,394 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <cmath>
+#include <cstdlib>
+#include <cerrno>
+#include <vector>
+#include <string>
+#include <sys/stat.h>
+#include <SFML/Graphics.hpp>
+#include <nyra/Logger.h>
+#include <nyra/Engine.h>
+#include <nyra/Constants.h>
+#include <nyra/Profiler.h>
+
+namespace
+{
+//===========================================================================//
+static const double SPACING = 20.0;
+static const double FLOOR_WIDTH = 100000.0;
+
+//===========================================================================//
+struct Options
+{
+    Options() :
+        scenario("all"),
+        ticks(600),
+        dataDir("bench_data"),
+        output("bench_results.json"),
+        window(false)
+    {
+        counts.push_back(100);
+        counts.push_back(1000);
+        counts.push_back(10000);
+    }
+
+    std::string scenario;
+    std::vector<size_t> counts;
+    size_t ticks;
+    std::string dataDir;
+    std::string output;
+    bool window;
+};
+
+//===========================================================================//
+struct Result
+{
+    std::string scenario;
+    size_t count;
+    size_t ticks;
+    double loadTime;
+    double runTime;
+    std::vector<std::pair<std::string, nyra::ProfileStats> > phases;
+};
+
+//===========================================================================//
+void usage()
+{
+    std::cout <<
+        "Usage: bench [options]\n"
+        "  --scenario <name>  dynamic, scripted, static, mixed or all\n"
+        "  --counts <n,n,...> Actor counts to run each scenario with\n"
+        "  --ticks <n>        Number of engine updates per run\n"
+        "  --data <dir>       Directory to generate the test data in\n"
+        "  --output <file>    Pathname of the JSON results\n"
+        "  --window           Render to a window instead of headless\n";
+}
+
+//===========================================================================//
+std::vector<size_t> parseCounts(const std::string& value)
+{
+    std::vector<size_t> counts;
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        counts.push_back(std::stoul(item));
+    }
+    return counts;
+}
+
+//===========================================================================//
+Options parseOptions(int argc, char** argv)
+{
+    Options options;
+    for (int ii = 1; ii < argc; ++ii)
+    {
+        const std::string arg(argv[ii]);
+        const bool hasValue = ii + 1 < argc;
+        if (arg == "--window")
+        {
+            options.window = true;
+        }
+        else if (arg == "--scenario" && hasValue)
+        {
+            options.scenario = argv[++ii];
+        }
+        else if (arg == "--counts" && hasValue)
+        {
+            options.counts = parseCounts(argv[++ii]);
+        }
+        else if (arg == "--ticks" && hasValue)
+        {
+            options.ticks = std::stoul(argv[++ii]);
+        }
+        else if (arg == "--data" && hasValue)
+        {
+            options.dataDir = argv[++ii];
+        }
+        else if (arg == "--output" && hasValue)
+        {
+            options.output = argv[++ii];
+        }
+        else
+        {
+            usage();
+            throw std::runtime_error("Invalid argument: " + arg);
+        }
+    }
+    return options;
+}
+
+//===========================================================================//
+void makeDirectory(const std::string& pathname)
+{
+    if (mkdir(pathname.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+        throw std::runtime_error("Unable to create directory: " + pathname);
+    }
+}
+
+//===========================================================================//
+void writeFile(const std::string& pathname,
+               const std::string& contents)
+{
+    std::ofstream file(pathname);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Unable to write file: " + pathname);
+    }
+    file << contents;
+}
+
+//===========================================================================//
+std::string toJSON(double value)
+{
+    // JSONNode only accepts numbers written as doubles
+    return std::to_string(value);
+}
+
+//===========================================================================//
+void writeData(const std::string& dataDir)
+{
+    makeDirectory(dataDir);
+    makeDirectory(dataDir + "/actors");
+    makeDirectory(dataDir + "/maps");
+    makeDirectory(dataDir + "/textures");
+    makeDirectory(dataDir + "/scripts");
+
+    sf::Image image;
+    image.create(16, 16, sf::Color::White);
+    if (!image.saveToFile(dataDir + "/textures/bench_box.png"))
+    {
+        throw std::runtime_error("Unable to write bench texture");
+    }
+
+    const std::string sprite =
+        "    \"sprite\": {\"filename\": \"bench_box\"}";
+    const std::string box =
+        "    \"physics\": {\"type\": \"dynamic\", \"shape\": "
+        "{\"type\": \"box\", \"size\": {\"width\": 16.0, \"height\": 16.0}}}";
+
+    writeFile(dataDir + "/actors/bench_dynamic.json",
+              "{\n" + sprite + ",\n" + box + "\n}\n");
+    writeFile(dataDir + "/actors/bench_static.json",
+              "{\n" + sprite + "\n}\n");
+    writeFile(dataDir + "/actors/bench_scripted.json",
+              "{\n" + sprite + ",\n"
+              "    \"script\": {\"module\": \"bench_script\", "
+              "\"class\": \"BenchScript\", \"update\": \"update\"}\n}\n");
+    writeFile(dataDir + "/actors/bench_floor.json",
+              "{\n    \"physics\": {\"type\": \"static\", \"shape\": "
+              "{\"type\": \"box\", \"size\": {\"width\": " +
+              toJSON(FLOOR_WIDTH) + ", \"height\": 20.0}}}\n}\n");
+
+    writeFile(dataDir + "/scripts/bench_script.py",
+              "import nyra\n"
+              "\n"
+              "class BenchScript(nyra.Actor):\n"
+              "    def update(self, delta):\n"
+              "        x, y = self.position\n");
+}
+
+//===========================================================================//
+std::string writeMap(const std::string& dataDir,
+                     const std::string& scenario,
+                     size_t count)
+{
+    std::vector<std::string> actors;
+    if (scenario == "mixed")
+    {
+        actors.push_back("bench_dynamic");
+        actors.push_back("bench_scripted");
+        actors.push_back("bench_static");
+    }
+    else
+    {
+        actors.push_back("bench_" + scenario);
+    }
+
+    const size_t columns = static_cast<size_t>(
+            std::ceil(std::sqrt(static_cast<double>(count))));
+    const size_t rows = columns ? (count + columns - 1) / columns : 0;
+
+    std::string map = "{\n    \"actors\": [\n";
+    map += "        {\"filename\": \"bench_floor\", \"position\": "
+           "{\"x\": " + toJSON(0.0) + ", \"y\": " +
+           toJSON((rows + 2) * SPACING) + "}}";
+    for (size_t ii = 0; ii < count; ++ii)
+    {
+        map += ",\n        {\"filename\": \"" + actors[ii % actors.size()] +
+               "\", \"position\": {\"x\": " +
+               toJSON((ii % columns) * SPACING) + ", \"y\": " +
+               toJSON((ii / columns) * SPACING) + "}}";
+    }
+    map += "\n    ]\n}\n";
+
+    const std::string name = "bench_" + scenario + "_" + std::to_string(count);
+    writeFile(dataDir + "/maps/" + name + ".json", map);
+    return name;
+}
+
+//===========================================================================//
+Result run(nyra::Engine& engine,
+           const Options& options,
+           const std::string& scenario,
+           size_t count)
+{
+    Result result;
+    result.scenario = scenario;
+    result.count = count;
+    result.ticks = 0;
+
+    const std::string map = writeMap(options.dataDir, scenario, count);
+    nyra::Profiler& profiler = engine.getProfiler();
+
+    const int64_t loadStart = nyra::Profiler::now();
+    engine.loadMap(map);
+    result.loadTime = (nyra::Profiler::now() - loadStart) / 1000.0;
+
+    profiler.clear();
+    const int64_t runStart = nyra::Profiler::now();
+    while (result.ticks < options.ticks && engine.update())
+    {
+        ++result.ticks;
+    }
+    result.runTime = (nyra::Profiler::now() - runStart) / 1000.0;
+
+    for (const std::string& phase : profiler.getPhases())
+    {
+        result.phases.push_back(std::make_pair(
+                phase, profiler.getStats(phase)));
+    }
+    return result;
+}
+
+//===========================================================================//
+void writeResults(const std::string& pathname,
+                  const std::vector<Result>& results)
+{
+    std::ofstream file(pathname);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Unable to write results: " + pathname);
+    }
+
+    file << "{\n    \"runs\": [";
+    for (size_t ii = 0; ii < results.size(); ++ii)
+    {
+        const Result& result = results[ii];
+        file << (ii ? ",\n" : "\n")
+             << "        {\"scenario\": \"" << result.scenario << "\", "
+             << "\"actors\": " << result.count << ", "
+             << "\"ticks\": " << result.ticks << ", "
+             << "\"load_ms\": " << result.loadTime << ", "
+             << "\"run_ms\": " << result.runTime << ", "
+             << "\"phases\": {";
+        for (size_t jj = 0; jj < result.phases.size(); ++jj)
+        {
+            const nyra::ProfileStats& stats = result.phases[jj].second;
+            file << (jj ? ", " : "")
+                 << "\"" << result.phases[jj].first << "\": {"
+                 << "\"count\": " << stats.count << ", "
+                 << "\"min\": " << stats.minimum << ", "
+                 << "\"avg\": " << stats.average << ", "
+                 << "\"max\": " << stats.maximum << ", "
+                 << "\"p99\": " << stats.p99 << "}";
+        }
+        file << "}}";
+    }
+    file << "\n    ]\n}\n";
+}
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        nyra::Logger::registerLogger(nyra::Logger::INFO, "./bench_log.txt");
+        const Options options = parseOptions(argc, argv);
+        writeData(options.dataDir);
+
+        // Make the generated script and the nyra module importable
+        const char* pythonPath = std::getenv("PYTHONPATH");
+        const std::string path = options.dataDir + "/scripts:" +
+                nyra::Constants::APP_PATH + "../python" +
+                (pythonPath ? std::string(":") + pythonPath : "");
+        setenv("PYTHONPATH", path.c_str(), 1);
+
+        nyra::Config config;
+        config.title = "Nyra Bench";
+        config.dataDir = options.dataDir;
+        config.headless = !options.window;
+        config.vsync = false;
+
+        // Never hold frames back when rendering to a window
+        config.framesPerSecond = 1000000.0;
+        nyra::Engine engine(config);
+
+        std::vector<std::string> scenarios;
+        if (options.scenario == "all")
+        {
+            scenarios.push_back("dynamic");
+            scenarios.push_back("scripted");
+            scenarios.push_back("static");
+            scenarios.push_back("mixed");
+        }
+        else
+        {
+            scenarios.push_back(options.scenario);
+        }
+
+        std::vector<Result> results;
+        for (const std::string& scenario : scenarios)
+        {
+            for (size_t count : options.counts)
+            {
+                results.push_back(run(engine, options, scenario, count));
+                nyra::Logger::info("Finished " + scenario + " with " +
+                                   std::to_string(count) + " actors in " +
+                                   std::to_string(results.back().runTime) +
+                                   " ms");
+            }
+        }
+
+        writeResults(options.output, results);
+        return 0;
+    }
+    catch (const std::exception& ex)
+    {
+        nyra::Logger::error(
+                std::string("Caught standard exception: ") + ex.what());
+    }
+    catch (...)
+    {
+        nyra::Logger::error("Caught unnamed exception");
+    }
+
+    return 1;
+}
@@ -25,64 +25,58 @@
 #define NYRA_ACTOR_H_
 
 #include <string>
-#include <nyra/Sprite.h>
 #include <nyra/Vector2.h>
-#include <nyra/Script.h>
-#include <nyra/PhysicsBody.h>
+#include <nyra/ComponentStore.h>
 
 namespace nyra
 {
 /*
  *  \class Actor
  *  \brief Provides a common interface for a component based entity system.
- *         Individual components can be added an maintained here.
- *         This never owns memory. It is used to manage how components fit
- *         together.
+ *         The components themselves live in a ComponentStore. This never
+ *         owns memory. It is used to manage how components fit together.
+ *         An Actor is a small value that refers to its components through
+ *         a handle so it is safe to copy and hold onto. Using an Actor
+ *         whose components have been removed throws.
  */
 class Actor
 {
 public:
     /*
      *  \func Constructor
-     *  \brief Sets up the internal structure of the Actor class. All components
-     *         will start in a NULL state.
+     *  \brief Creates an Actor that does not refer to anything.
      */
     Actor();
 
     /*
-     *  \func setSprite
-     *  \brief Sets the Actor sprite object. This should be used internally
-     *         only.
+     *  \func Constructor
+     *  \brief Sets up the internal structure of the Actor class.
      *
-     *  \param sprite The sprite that will be associated with this Actor.
+     *  \param store The store that holds the actor's components.
+     *  \param handle The handle of the actor within the store.
      */
-    inline void setSprite(Sprite& sprite)
-    {
-        mSprite = &sprite;
-    }
+    Actor(ComponentStore& store, ActorHandle handle);
 
     /*
-     *  \func setScript
-     *  \brief Sets the Actor script object. This should be used internally
-     *         only.
+     *  \func getHandle
+     *  \brief Gets the handle of the actor within its component store.
      *
-     *  \param script The script that will be associated with the Actor.
+     *  \return The actor handle.
      */
-    inline void setScript(Script& script)
+    inline ActorHandle getHandle() const
     {
-        mScript = &script;
+        return mHandle;
     }
 
     /*
-     *  \func setPhysics
-     *  \brief Sets the Actor physics body object. This should be used
-     *         internally only.
+     *  \func isValid
+     *  \brief Checks if the actor still exists.
      *
-     *  \param physics The physics body that will associated with the Actor.
+     *  \return True if the actor's components can be used.
      */
-    inline void setPhysics(PhysicsBody& physics)
+    inline bool isValid() const
     {
-        mPhysics = &physics;
+        return mStore && mStore->isValid(mHandle);
     }
 
     /*
@@ -95,16 +89,35 @@ public:
      */
     void setPosition(const Vector2& position) const;
 
+    /*
+     *  \func setRotation
+     *  \brief Sets the rotation of the Actor.
+     *
+     *  \param rotation The desired rotation in degrees.
+     */
+    void setRotation(double rotation) const;
+
     /*
      *  \func getPosition
      *  \brief Gets the position of the Actor. This will go from most to least
-     *         likely components to try to find a position.
+     *         likely components to try to find a position. Physics is
+     *         preferred because sprites may be blended between steps.
      *
      *  \return The Actor position
      *  \warn Warns if no components contain positional information.
      */
     Vector2 getPosition() const;
 
+    /*
+     *  \func getRenderPosition
+     *  \brief Gets the position the Actor is drawn at. This can trail the
+     *         physics position by up to one step.
+     *
+     *  \return The Actor position as seen on screen.
+     *  \warn Warns if no components contain positional information.
+     */
+    Vector2 getRenderPosition() const;
+
     /*
      *  \func getVelocity
      *  \brief Gets the linear velocity of the actor in meters per second
@@ -133,22 +146,26 @@ public:
     void applyForce(const Vector2& force) const;
 
     /*
-     *  \func getVelocity
-     *  \brief Gets the linear velocity of the Actor.
+     *  \func attach
+     *  \brief Attaches the actor to a parent. From then on it is placed
+     *         relative to the parent every frame and setting its position
+     *         has no lasting effect.
      *
-     *  \return The Actor's velocity
-     *  \warn Warns if there is no physics component.
+     *  \param parent The actor to follow.
+     *  \param offset The position relative to the parent in pixels.
+     *  \param rotation The rotation relative to the parent in degrees.
+     *  \throw If the parent is this actor or one of its children.
      */
+    void attach(const Actor& parent,
+                const Vector2& offset,
+                double rotation) const;
 
     /*
-     *  \func updateGraphicsWithPhysics
-     *  \brief If the physics updates the its transform, then the sprites needs
-     *         to also update its transform. This call transfers that
-     *         information. This should only be called internally.
-     *
-     *  \warn Warns if there is not a physics or sprite component.
+     *  \func detach
+     *  \brief Detaches the actor from its parent. It stays where it was
+     *         last placed.
      */
-    void updateGraphicsWithPhysics() const;
+    void detach() const;
 
     /*
      *  \func hasSprite
@@ -158,7 +175,7 @@ public:
      */
     bool hasSprite() const
     {
-        return mSprite != nullptr;
+        return mStore->hasSprite(getId());
     }
 
     /*
@@ -169,7 +186,7 @@ public:
      */
     bool hasScript() const
     {
-        return mScript != nullptr;
+        return mStore->hasScript(getId());
     }
 
     /*
@@ -180,13 +197,14 @@ public:
      */
     bool hasPhysics() const
     {
-        return mPhysics != nullptr;
+        return mStore->hasPhysics(getId());
     }
 
 private:
-    Sprite* mSprite;
-    Script* mScript;
-    PhysicsBody* mPhysics;
+    size_t getId() const;
+
+    ComponentStore* mStore;
+    ActorHandle mHandle;
 };
 }
 
@@ -0,0 +1,85 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#ifndef NYRA_ACTOR_HANDLE_H_
+#define NYRA_ACTOR_HANDLE_H_
+
+#include <stdint.h>
+
+namespace nyra
+{
+/*
+ *  \type ActorHandle
+ *  \brief Identifies an actor without pointing at its memory. The low 32
+ *         bits are the index of a slot and the high 32 bits are the
+ *         generation of that slot. A slot's generation changes each time
+ *         its actor is removed so old handles can be detected.
+ */
+typedef uint64_t ActorHandle;
+
+/*
+ *  \var INVALID_ACTOR
+ *  \brief A handle that never refers to an actor. Generations start at one
+ *         so no live actor has this value.
+ */
+static const ActorHandle INVALID_ACTOR = 0;
+
+/*
+ *  \func makeActorHandle
+ *  \brief Packs a slot index and generation into a handle.
+ *
+ *  \param index The index of the slot.
+ *  \param generation The generation of the slot.
+ *  \return The handle.
+ */
+inline ActorHandle makeActorHandle(uint32_t index, uint32_t generation)
+{
+    return (static_cast<ActorHandle>(generation) << 32) | index;
+}
+
+/*
+ *  \func getHandleIndex
+ *  \brief Gets the slot index out of a handle.
+ *
+ *  \param handle The handle.
+ *  \return The slot index.
+ */
+inline uint32_t getHandleIndex(ActorHandle handle)
+{
+    return static_cast<uint32_t>(handle);
+}
+
+/*
+ *  \func getHandleGeneration
+ *  \brief Gets the slot generation out of a handle.
+ *
+ *  \param handle The handle.
+ *  \return The slot generation.
+ */
+inline uint32_t getHandleGeneration(ActorHandle handle)
+{
+    return static_cast<uint32_t>(handle >> 32);
+}
+}
+
+#endif
@@ -0,0 +1,217 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#ifndef NYRA_ARENA_H_
+#define NYRA_ARENA_H_
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+
+namespace nyra
+{
+/*
+ *  \class Arena
+ *  \brief A bump allocator for objects that live as long as a map. Memory
+ *         is handed out from large blocks and is only given back all at
+ *         once by reset, which keeps the blocks for the next map. Nothing
+ *         is destructed by the arena.
+ */
+class Arena
+{
+public:
+    /*
+     *  \func Constructor
+     *  \brief Creates an empty arena. No memory is allocated until the
+     *         first allocation.
+     *
+     *  \param blockSize The size in bytes of each block.
+     */
+    Arena(size_t blockSize);
+
+    /*
+     *  \func allocate
+     *  \brief Gets uninitialized memory from the arena.
+     *
+     *  \param size The number of bytes.
+     *  \param alignment The alignment of the memory. This must be a power
+     *         of two.
+     *  \return The memory.
+     *  \throw If size is larger than a block.
+     */
+    void* allocate(size_t size, size_t alignment);
+
+    /*
+     *  \func reset
+     *  \brief Makes every allocation available again. This does not free
+     *         or touch the blocks so it takes constant time. Everything
+     *         allocated before this is no longer valid. The high water
+     *         mark starts over.
+     */
+    void reset();
+
+    /*
+     *  \func getUsed
+     *  \brief Gets the number of bytes handed out since the last reset.
+     *
+     *  \return The number of bytes including alignment padding.
+     */
+    inline size_t getUsed() const
+    {
+        return mUsed;
+    }
+
+    /*
+     *  \func getHighWaterMark
+     *  \brief Gets the most bytes that have been in use at once since the
+     *         last reset.
+     *
+     *  \return The number of bytes.
+     */
+    inline size_t getHighWaterMark() const
+    {
+        return mHighWaterMark;
+    }
+
+    /*
+     *  \func getCapacity
+     *  \brief Gets the number of bytes held in blocks.
+     *
+     *  \return The number of bytes.
+     */
+    inline size_t getCapacity() const
+    {
+        return mBlocks.size() * mBlockSize;
+    }
+
+private:
+    const size_t mBlockSize;
+    std::vector<std::unique_ptr<char[]> > mBlocks;
+    size_t mBlock;
+    size_t mOffset;
+    size_t mUsed;
+    size_t mHighWaterMark;
+};
+
+/*
+ *  \class ArenaPool
+ *  \brief Creates objects of one type in an arena. Destroyed objects are
+ *         kept on a free list and reused before more of the arena is
+ *         taken, so actors that come and go during a map do not grow it.
+ *
+ *  \tparam T The type of object.
+ */
+template <typename T>
+class ArenaPool
+{
+public:
+    /*
+     *  \func Constructor
+     *  \brief Creates an empty pool.
+     *
+     *  \param arena The arena that holds the objects.
+     */
+    ArenaPool(Arena& arena) :
+        mArena(arena),
+        mFree(nullptr)
+    {
+    }
+
+    /*
+     *  \func create
+     *  \brief Constructs an object.
+     *
+     *  \param args The arguments passed to the constructor.
+     *  \return The object.
+     */
+    template <typename... ArgsT>
+    T* create(ArgsT&&... args)
+    {
+        void* memory;
+        if (mFree)
+        {
+            memory = mFree;
+            mFree = mFree->next;
+        }
+        else
+        {
+            memory = mArena.allocate(sizeof(Node), alignof(Node));
+        }
+
+        // Put the slot back if the constructor throws
+        try
+        {
+            return new (memory) T(std::forward<ArgsT>(args)...);
+        }
+        catch (...)
+        {
+            release(memory);
+            throw;
+        }
+    }
+
+    /*
+     *  \func destroy
+     *  \brief Destructs an object and keeps its memory for reuse.
+     *
+     *  \param object The object. It is no longer valid after this.
+     */
+    void destroy(T* object)
+    {
+        object->~T();
+        release(object);
+    }
+
+    /*
+     *  \func reset
+     *  \brief Forgets every object. Objects that need their destructor run
+     *         must be destroyed first. Call this when the arena is reset.
+     */
+    inline void reset()
+    {
+        mFree = nullptr;
+    }
+
+private:
+    union Node
+    {
+        Node* next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type object;
+    };
+
+    void release(void* memory)
+    {
+        Node* node = static_cast<Node*>(memory);
+        node->next = mFree;
+        mFree = node;
+    }
+
+    Arena& mArena;
+    Node* mFree;
+};
+}
+
+#endif
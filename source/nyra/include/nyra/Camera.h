@@ -44,7 +44,8 @@ public:
 
     /*
      *  \func track
-     *  \brief Sets the camera to track a target.
+     *  \brief Sets the camera to track a target. Tracking stops on its
+     *         own if the target is removed.
      *
      *  \param target The target to track.
      *  \param offset An offset to apply to the target
@@ -60,10 +61,9 @@ public:
      *  \func update
      *  \brief Updates the camera position.
      *
-     *  \param deltaTime The time that has passed since the last update
      *  \param view The view to apply changes to
      */
-    void update(sf::RenderTarget& render);
+    void update(sf::View& view);
 
     /*
      *  \func reset
@@ -72,7 +72,7 @@ public:
     void reset();
 
 private:
-    const Actor* mTarget;
+    Actor mTarget;
     Vector2 mOffset;
 
     // TODO: Implement a frame independent lerp.
@@ -0,0 +1,589 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#ifndef NYRA_COMPONENT_STORE_H_
+#define NYRA_COMPONENT_STORE_H_
+
+#include <vector>
+#include <string>
+#include <limits>
+#include <unordered_map>
+#include <nyra/Vector2.h>
+#include <nyra/ActorHandle.h>
+#include <nyra/Graphics.h>
+#include <nyra/Sprite.h>
+#include <nyra/Script.h>
+#include <nyra/PhysicsBody.h>
+
+namespace nyra
+{
+/*
+ *  \class Transform
+ *  \brief The position and rotation an actor is drawn at.
+ */
+struct Transform
+{
+    /*
+     *  \var position
+     *  \brief The position in pixels.
+     */
+    Vector2 position;
+
+    /*
+     *  \var rotation
+     *  \brief The rotation in degrees.
+     */
+    double rotation;
+};
+
+/*
+ *  \typedef ComponentMask
+ *  \brief One bit for each type of component plus one for each tag. An
+ *         actor matches a query if it has every bit the query asks for.
+ */
+typedef uint64_t ComponentMask;
+
+/*
+ *  \class ComponentStore
+ *  \brief Holds the components of every actor in dense arrays indexed by
+ *         actor id. Each array holds one type of component so per frame
+ *         systems can walk them linearly rather than visiting actors one
+ *         at a time. Ids are only stable until actors are removed, so
+ *         anything held outside of a frame should use an ActorHandle,
+ *         which is resolved to an id through a slot table.
+ */
+class ComponentStore
+{
+public:
+    /*
+     *  \var NO_SPRITE
+     *  \brief The sprite index used for actors without a sprite.
+     */
+    static const size_t NO_SPRITE;
+
+    /*
+     *  \var NO_POOL
+     *  \brief The pool index used for actors that are not pooled.
+     */
+    static const size_t NO_POOL;
+
+    /*
+     *  \var SPRITE_MASK
+     *  \brief The bit set on actors with a sprite.
+     */
+    static const ComponentMask SPRITE_MASK;
+
+    /*
+     *  \var PHYSICS_MASK
+     *  \brief The bit set on actors with a physics body.
+     */
+    static const ComponentMask PHYSICS_MASK;
+
+    /*
+     *  \var SCRIPT_MASK
+     *  \brief The bit set on actors with a script.
+     */
+    static const ComponentMask SCRIPT_MASK;
+
+    /*
+     *  \func Constructor
+     *  \brief Creates an empty store.
+     *
+     *  \param graphics The graphics that own the sprites referenced here.
+     */
+    ComponentStore(Graphics& graphics);
+
+    /*
+     *  \func addActor
+     *  \brief Adds an actor with no components.
+     *
+     *  \return The handle of the new actor.
+     */
+    ActorHandle addActor();
+
+    /*
+     *  \func reserve
+     *  \brief Makes room for more actors so adding them does not grow
+     *         every component array one at a time.
+     *
+     *  \param count The number of actors about to be added.
+     */
+    void reserve(size_t count);
+
+    /*
+     *  \func removeActor
+     *  \brief Removes an actor and its sprite. The last actor is moved
+     *         into its place so ids of other actors can change. The
+     *         actor's slot is recycled with a new generation. Bodies and
+     *         scripts are owned elsewhere and must be released by the
+     *         caller first.
+     *
+     *  \param handle The handle of the actor.
+     *  \throw If the actor no longer exists.
+     */
+    void removeActor(ActorHandle handle);
+
+    /*
+     *  \func clear
+     *  \brief Removes every actor. Every handle given out before this is
+     *         no longer valid.
+     */
+    void clear();
+
+    /*
+     *  \func isValid
+     *  \brief Checks if a handle refers to an actor that still exists.
+     *
+     *  \param handle The handle to check.
+     *  \return True if the actor exists.
+     */
+    inline bool isValid(ActorHandle handle) const
+    {
+        const uint32_t index = getHandleIndex(handle);
+        return index < mSlots.size() &&
+               mSlots[index].alive &&
+               mSlots[index].generation == getHandleGeneration(handle);
+    }
+
+    /*
+     *  \func getId
+     *  \brief Resolves a handle to the current id of its actor.
+     *
+     *  \param handle The handle to resolve.
+     *  \return The id of the actor.
+     *  \throw If the actor no longer exists.
+     */
+    size_t getId(ActorHandle handle) const;
+
+    /*
+     *  \func getHandle
+     *  \brief Gets the handle of an actor.
+     *
+     *  \param id The id of the actor.
+     *  \return The handle of the actor.
+     */
+    inline ActorHandle getHandle(size_t id) const
+    {
+        return mHandles[id];
+    }
+
+    /*
+     *  \func setSprite
+     *  \brief Associates a sprite with an actor.
+     *
+     *  \param id The id of the actor.
+     *  \param sprite The index of the sprite within the graphics.
+     */
+    void setSprite(size_t id, size_t sprite);
+
+    /*
+     *  \func setPhysics
+     *  \brief Associates a physics body with an actor. If the body can move
+     *         and the actor has a sprite the sprite is synced with the body
+     *         every frame. The sprite should be set first.
+     *
+     *  \param id The id of the actor.
+     *  \param body The physics body.
+     */
+    void setPhysics(size_t id, PhysicsBody& body);
+
+    /*
+     *  \func clearPhysics
+     *  \brief Removes the physics body from an actor without destroying
+     *         it. The actor keeps its transform.
+     *
+     *  \param id The id of the actor.
+     */
+    void clearPhysics(size_t id);
+
+    /*
+     *  \func setScript
+     *  \brief Associates a script with an actor.
+     *
+     *  \param id The id of the actor.
+     *  \param script The script.
+     */
+    void setScript(size_t id, Script& script);
+
+    /*
+     *  \func setActive
+     *  \brief Sets whether an actor is part of the scene. Inactive actors
+     *         keep their components but their sprite is hidden and they
+     *         are skipped when syncing. Bodies and scripts are owned
+     *         elsewhere and must be changed by the caller.
+     *
+     *  \param id The id of the actor.
+     *  \param active True if the actor is part of the scene.
+     */
+    void setActive(size_t id, bool active);
+
+    /*
+     *  \func isActive
+     *  \brief Checks if an actor is part of the scene.
+     *
+     *  \param id The id of the actor.
+     *  \return True if the actor is active.
+     */
+    inline bool isActive(size_t id) const
+    {
+        return mActive[id];
+    }
+
+    /*
+     *  \func setPool
+     *  \brief Records which pool an actor is returned to when despawned.
+     *
+     *  \param id The id of the actor.
+     *  \param pool The index of the pool.
+     */
+    inline void setPool(size_t id, size_t pool)
+    {
+        mPools[id] = pool;
+    }
+
+    /*
+     *  \func getPool
+     *  \brief Gets the pool an actor belongs to.
+     *
+     *  \param id The id of the actor.
+     *  \return The index of the pool or NO_POOL.
+     */
+    inline size_t getPool(size_t id) const
+    {
+        return mPools[id];
+    }
+
+    /*
+     *  \func setParent
+     *  \brief Attaches an actor to a parent. Its transform then follows
+     *         the parent with a fixed offset and its sprite and body are
+     *         moved with it rather than by physics. Bodies on children
+     *         should be kinematic.
+     *
+     *  \param id The id of the child actor.
+     *  \param parent The handle of the parent actor.
+     *  \param local The transform relative to the parent.
+     *  \throw If the parent no longer exists or is the child or one of
+     *         its descendants.
+     */
+    void setParent(size_t id, ActorHandle parent, const Transform& local);
+
+    /*
+     *  \func clearParent
+     *  \brief Detaches an actor from its parent. The actor stays where it
+     *         was last placed.
+     *
+     *  \param id The id of the actor.
+     */
+    void clearParent(size_t id);
+
+    /*
+     *  \func getParent
+     *  \brief Gets the parent of an actor.
+     *
+     *  \param id The id of the actor.
+     *  \return The handle of the parent or INVALID_ACTOR.
+     */
+    inline ActorHandle getParent(size_t id) const
+    {
+        return mParents[id];
+    }
+
+    /*
+     *  \func addDescendants
+     *  \brief Appends every descendant of the given actors that is not
+     *         already in the list.
+     *
+     *  \param handles The handles of the actors. Descendants are added to
+     *         the end.
+     */
+    void addDescendants(std::vector<ActorHandle>& handles);
+
+    /*
+     *  \func propagateTransforms
+     *  \brief Places every active child at its parent's transform plus its
+     *         local offset. Parents are always placed before their
+     *         children so a whole hierarchy is updated in one pass.
+     *         Children are skipped while their parent has not moved since
+     *         they were last placed.
+     */
+    void propagateTransforms();
+
+    /*
+     *  \func getTagMask
+     *  \brief Gets the bit for a tag. Each new tag is given the next free
+     *         bit. Tags keep their bit for the life of the store.
+     *
+     *  \param tag The name of the tag.
+     *  \return The bit of the tag.
+     *  \throw If there are no free bits left.
+     */
+    ComponentMask getTagMask(const std::string& tag);
+
+    /*
+     *  \func addTags
+     *  \brief Adds tags to an actor.
+     *
+     *  \param id The id of the actor.
+     *  \param tags The bits of the tags.
+     */
+    void addTags(size_t id, ComponentMask tags);
+
+    /*
+     *  \func getMask
+     *  \brief Gets the components and tags of an actor.
+     *
+     *  \param id The id of the actor.
+     *  \return The mask of the actor.
+     */
+    inline ComponentMask getMask(size_t id) const
+    {
+        return mMasks[id];
+    }
+
+    /*
+     *  \func hasTags
+     *  \brief Checks if an actor has any tags.
+     *
+     *  \param id The id of the actor.
+     *  \return True if the actor has at least one tag.
+     */
+    inline bool hasTags(size_t id) const
+    {
+        return (mMasks[id] & ~(SPRITE_MASK | PHYSICS_MASK | SCRIPT_MASK)) != 0;
+    }
+
+    /*
+     *  \func addQuery
+     *  \brief Gets a query for every active actor that has all of the
+     *         bits in mask. Queries with the same mask are shared. The
+     *         results are kept up to date as actors change, so reading
+     *         them is free.
+     *
+     *  \param mask The components and tags to match.
+     *  \return The index of the query.
+     */
+    size_t addQuery(ComponentMask mask);
+
+    /*
+     *  \func getQueryResults
+     *  \brief Gets the actors that currently match a query. The order is
+     *         not stable.
+     *
+     *  \param query The index of the query.
+     *  \return The handles of the matching actors.
+     */
+    inline const std::vector<ActorHandle>& getQueryResults(size_t query) const
+    {
+        return mQueries[query].results;
+    }
+
+    /*
+     *  \func getQueryCount
+     *  \brief Gets the number of queries that have been added.
+     *
+     *  \return The number of queries.
+     */
+    inline size_t getQueryCount() const
+    {
+        return mQueries.size();
+    }
+
+    /*
+     *  \func syncGraphicsWithPhysics
+     *  \brief Moves the synced sprites of the given bodies to their body's
+     *         transform blended between the last two physics steps. Only
+     *         bodies that may have moved need to be passed so the cost
+     *         follows motion rather than the number of actors.
+     *
+     *  \param bodies The bodies that may have moved.
+     *  \param alpha How far between the previous and current physics step
+     *         the sprites should be placed (0 - 1).
+     */
+    void syncGraphicsWithPhysics(const std::vector<PhysicsBody*>& bodies,
+                                 double alpha);
+
+    /*
+     *  \func hasSprite
+     *  \brief Checks if an actor has a sprite.
+     *
+     *  \param id The id of the actor.
+     *  \return True if there is a sprite.
+     */
+    inline bool hasSprite(size_t id) const
+    {
+        return mSprites[id] != NO_SPRITE;
+    }
+
+    /*
+     *  \func hasPhysics
+     *  \brief Checks if an actor has a physics body.
+     *
+     *  \param id The id of the actor.
+     *  \return True if there is a physics body.
+     */
+    inline bool hasPhysics(size_t id) const
+    {
+        return mBodies[id] != nullptr;
+    }
+
+    /*
+     *  \func hasScript
+     *  \brief Checks if an actor has a script.
+     *
+     *  \param id The id of the actor.
+     *  \return True if there is a script.
+     */
+    inline bool hasScript(size_t id) const
+    {
+        return mScripts[id] != nullptr;
+    }
+
+    /*
+     *  \func getSprite
+     *  \brief Gets the sprite of an actor. Check hasSprite first.
+     *
+     *  \param id The id of the actor.
+     *  \return The sprite.
+     */
+    inline Sprite& getSprite(size_t id)
+    {
+        return mGraphics.getSprite(mSprites[id]);
+    }
+
+    /*
+     *  \func getPhysics
+     *  \brief Gets the physics body of an actor. Check hasPhysics first.
+     *
+     *  \param id The id of the actor.
+     *  \return The physics body.
+     */
+    inline PhysicsBody& getPhysics(size_t id)
+    {
+        return *mBodies[id];
+    }
+
+    /*
+     *  \func getScript
+     *  \brief Gets the script of an actor. Check hasScript first.
+     *
+     *  \param id The id of the actor.
+     *  \return The script.
+     */
+    inline Script& getScript(size_t id)
+    {
+        return *mScripts[id];
+    }
+
+    /*
+     *  \func getTransform
+     *  \brief Gets the transform an actor is drawn with.
+     *
+     *  \param id The id of the actor.
+     *  \return The transform.
+     */
+    inline Transform& getTransform(size_t id)
+    {
+        return mTransforms[id];
+    }
+
+    /*
+     *  \func getSize
+     *  \brief Gets the number of actors in the store.
+     *
+     *  \return The number of actors.
+     */
+    inline size_t getSize() const
+    {
+        return mTransforms.size();
+    }
+
+private:
+    struct Slot
+    {
+        uint32_t generation;
+        bool alive;
+        size_t id;
+    };
+
+    // Where each actor is in the results is indexed by slot
+    struct Query
+    {
+        ComponentMask mask;
+        std::vector<ActorHandle> results;
+        std::vector<size_t> positions;
+    };
+
+    void releaseSlot(uint32_t index);
+
+    void sortHierarchy();
+
+    void updateQueries(size_t id);
+
+    void removeFromQueries(size_t id);
+
+    void setInQuery(Query& query, size_t id, bool matches);
+
+    Graphics& mGraphics;
+
+    // Handle resolution
+    std::vector<Slot> mSlots;
+    std::vector<uint32_t> mFreeSlots;
+    std::vector<ActorHandle> mHandles;
+
+    // Components indexed by actor id
+    std::vector<Transform> mTransforms;
+    std::vector<size_t> mSprites;
+    std::vector<PhysicsBody*> mBodies;
+    std::vector<Script*> mScripts;
+    std::vector<bool> mActive;
+    std::vector<size_t> mPools;
+
+    // Whether each actor's transform follows a moving body
+    std::vector<bool> mSynced;
+
+    // Components and tags of each actor and the queries over them
+    std::vector<ComponentMask> mMasks;
+    std::vector<Query> mQueries;
+    std::unordered_map<std::string, ComponentMask> mTags;
+
+    // Parents and offsets from them indexed by actor id
+    std::vector<ActorHandle> mParents;
+    std::vector<Transform> mLocals;
+    std::vector<size_t> mChildCounts;
+
+    // The parent transform each child was last placed from and whether it
+    // has to be placed again even if its parent has not moved
+    std::vector<Transform> mParentTransforms;
+    std::vector<bool> mStale;
+
+    // Ids of actors with a parent sorted so parents come first
+    std::vector<size_t> mHierarchy;
+    bool mHierarchyDirty;
+
+    // Actor ids indexed by sprite index
+    std::vector<size_t> mSpriteOwners;
+};
+}
+
+#endif
@@ -29,6 +29,7 @@
 
 #include <string>
 #include <nyra/Vector2.h>
+#include <nyra/PhysicsSettings.h>
 #include <nyra/JSONReader.h>
 
 namespace nyra
@@ -57,11 +58,27 @@ public:
 
     /*
      *  \var framesPerSecond
-     *  \brief The number of that are applied each second.
-     *         If vsync is on this is ignored.
+     *  \brief The number of frames that are rendered each second.
+     *         If vsync is on or the engine is headless this is ignored.
      */
     double framesPerSecond;
 
+    /*
+     *  \var stepsPerSecond
+     *  \brief The fixed rate that physics and scripts are updated at. This
+     *         is independent of the render rate. In headless mode each
+     *         update advances the engine by exactly one step.
+     */
+    double stepsPerSecond;
+
+    /*
+     *  \var maxStepsPerFrame
+     *  \brief The most simulation steps that can be run before a frame is
+     *         rendered. If the engine falls further behind than this the
+     *         extra time is dropped rather than trying to catch up.
+     */
+    size_t maxStepsPerFrame;
+
     /*
      *  \var title
      *  \brief The title of the window that is created. This can
@@ -93,6 +110,23 @@ public:
      */
     bool vsync;
 
+    /*
+     *  \var headless
+     *  \brief Should the engine run without a window? When set no graphics
+     *         or input devices are opened and each update advances the
+     *         simulation by a fixed amount of time as fast as possible.
+     */
+    bool headless;
+
+    /*
+     *  \var pipelined
+     *  \brief Should rendering run on its own thread? When set, the next
+     *         frame is simulated while the previous one is drawn from a
+     *         snapshot. Debug physics rendering is not available in this
+     *         mode. This is ignored when headless.
+     */
+    bool pipelined;
+
     /*
      *  \var gravity
      *  \brief The force of gravity in meters / second squared. Note
@@ -101,12 +135,42 @@ public:
      */
     Vector2 gravity;
 
+    /*
+     *  \var physics
+     *  \brief How accurately and expensively physics is solved.
+     */
+    PhysicsSettings physics;
+
+    /*
+     *  \var physicsThreads
+     *  \brief The number of worker threads used to step the physics
+     *         sectors of a map. The main thread steps sectors as well. By
+     *         default there is one for each core beyond the first.
+     */
+    size_t physicsThreads;
+
+    /*
+     *  \var mergeStaticTiles
+     *  \brief Should the static boxes of a map be merged into outlines
+     *         when it is loaded? Only tiles without scripts, tags or
+     *         parents are merged and they no longer have physics bodies.
+     */
+    bool mergeStaticTiles;
+
     /*
      *  \var defaultMap
      *  \brief The default map to load. If this is an empty string nothing
      *         is loaded.
      */
     std::string defaultMap;
+
+    /*
+     *  \var profileOutput
+     *  \brief A pathname to write a Chrome trace of the profiled frame
+     *         phases to when the engine shuts down. If this is an empty
+     *         string no trace is written.
+     */
+    std::string profileOutput;
 };
 }
 
@@ -0,0 +1,154 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#ifndef NYRA_CONTACT_LISTENER_H_
+#define NYRA_CONTACT_LISTENER_H_
+
+#include <vector>
+#include <utility>
+#include <Box2D/Box2D.h>
+#include <nyra/ActorHandle.h>
+
+namespace nyra
+{
+/*
+ *  \class Contact
+ *  \brief A record of two bodies starting or stopping touching.
+ */
+struct Contact
+{
+    /*
+     *  \var first
+     *  \brief The actor of the first body or INVALID_ACTOR.
+     */
+    ActorHandle first;
+
+    /*
+     *  \var second
+     *  \brief The actor of the second body or INVALID_ACTOR.
+     */
+    ActorHandle second;
+
+    /*
+     *  \var begin
+     *  \brief True if the bodies started touching and false if they
+     *         stopped.
+     */
+    bool begin;
+
+    /*
+     *  \var impulse
+     *  \brief The largest impulse used to push the bodies apart in the
+     *         step they started touching. This is zero for sensors and
+     *         for contacts that ended.
+     */
+    float32 impulse;
+
+    /*
+     *  \var point
+     *  \brief Where the bodies touch in meters.
+     */
+    b2Vec2 point;
+};
+
+/*
+ *  \class ContactListener
+ *  \brief Records contacts while the world is stepping. Nothing is called
+ *         back into scripts from inside the step. The records are kept
+ *         until they are read and cleared once per frame.
+ */
+class ContactListener : public b2ContactListener
+{
+public:
+    /*
+     *  \func Constructor
+     *  \brief Creates a listener with room for a number of contacts.
+     *
+     *  \param capacity The number of contacts to make room for.
+     */
+    ContactListener(size_t capacity);
+
+    /*
+     *  \func BeginContact
+     *  \brief Records two bodies starting to touch.
+     *
+     *  \param contact The Box2D contact.
+     */
+    void BeginContact(b2Contact* contact);
+
+    /*
+     *  \func EndContact
+     *  \brief Records two bodies no longer touching.
+     *
+     *  \param contact The Box2D contact.
+     */
+    void EndContact(b2Contact* contact);
+
+    /*
+     *  \func PostSolve
+     *  \brief Records the impulse of contacts that began this step.
+     *
+     *  \param contact The Box2D contact.
+     *  \param impulse The impulses used to separate the bodies.
+     */
+    void PostSolve(b2Contact* contact,
+                   const b2ContactImpulse* impulse);
+
+    /*
+     *  \func beginStep
+     *  \brief Forgets which contacts began in the last step. This should
+     *         be called before each step of the world.
+     */
+    inline void beginStep()
+    {
+        mBegun.clear();
+        mBegunSorted = true;
+    }
+
+    /*
+     *  \func getContacts
+     *  \brief Gets the contacts recorded since they were last cleared.
+     *
+     *  \return The contacts in the order they happened.
+     */
+    inline const std::vector<Contact>& getContacts() const
+    {
+        return mContacts;
+    }
+
+    /*
+     *  \func clear
+     *  \brief Drops every recorded contact. Memory is kept for reuse.
+     */
+    void clear();
+
+private:
+    void record(b2Contact* contact, bool begin);
+
+    std::vector<Contact> mContacts;
+    std::vector<std::pair<b2Contact*, size_t> > mBegun;
+    bool mBegunSorted;
+};
+}
+
+#endif
@@ -26,20 +26,26 @@
 
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <memory>
 #include <stdint.h>
 #include <nyra/Vector2.h>
 #include <nyra/GUI.h>
 #include <nyra/Sprite.h>
 #include <nyra/Actor.h>
+#include <nyra/ComponentStore.h>
+#include <nyra/PrefabCache.h>
 #include <nyra/Constants.h>
 #include <nyra/ScriptEngine.h>
 #include <nyra/Input.h>
 #include <nyra/Graphics.h>
 #include <nyra/Physics.h>
 #include <nyra/Logger.h>
+#include <nyra/Profiler.h>
 #include <nyra/PhysicsRenderer.h>
 #include <nyra/Camera.h>
+#include <nyra/EventBus.h>
+#include <nyra/Arena.h>
 #include <nyra/Config.h>
 
 namespace nyra
@@ -61,6 +67,12 @@ public:
      */
     Engine(const Config& config);
 
+    /*
+     *  \func Destructor
+     *  \brief Writes the profile trace if one was requested in the config.
+     */
+    ~Engine();
+
     /*
      *  \func update
      *  \brief Moves the engine forward by one frame.
@@ -85,8 +97,165 @@ public:
      *  \brief Creates a new managed actor.
      *
      *  \param filename The name of the actor file without an extension.
+     *  \return The actor that was created.
+     */
+    Actor addActor(const std::string& filename);
+
+    /*
+     *  \func addActors
+     *  \brief Creates many actors from one actor file. Storage for every
+     *         component is reserved once up front, so this is much faster
+     *         than calling addActor for each one. Scripts are not
+     *         initialized.
+     *
+     *  \param filename The name of the actor file without an extension.
+     *  \param positions The position of each actor.
+     *  \param rotations The rotation of each actor in degrees. This may be
+     *         empty to leave every actor unrotated.
+     *  \param handles The handles of the new actors are appended here.
+     *  \throw If there are rotations but not one for every position.
+     */
+    void addActors(const std::string& filename,
+                   const std::vector<Vector2>& positions,
+                   const std::vector<double>& rotations,
+                   std::vector<ActorHandle>& handles);
+
+    /*
+     *  \func initActors
+     *  \brief Calls init on the scripts of the given actors.
+     *
+     *  \param handles The handles of the actors.
+     */
+    void initActors(const std::vector<ActorHandle>& handles);
+
+    /*
+     *  \func destroyActor
+     *  \brief Queues an actor to be destroyed at the end of the current
+     *         frame. Its sprite, physics body and script are released
+     *         together and its handle becomes invalid. Destroying an actor
+     *         more than once is allowed.
+     *
+     *  \param actor The actor to destroy.
+     */
+    void destroyActor(const Actor& actor);
+
+    /*
+     *  \func prewarm
+     *  \brief Creates inactive actors in a pool so later spawns of that
+     *         actor file do not need to create anything.
+     *
+     *  \param filename The name of the actor file without an extension.
+     *  \param count The number of actors to add to the pool.
+     */
+    void prewarm(const std::string& filename, size_t count);
+
+    /*
+     *  \func spawn
+     *  \brief Takes an actor from a pool and places it in the scene. The
+     *         actor is stopped, unrotated and its script's init method is
+     *         called. If the pool is empty a new actor is created.
+     *
+     *  \param filename The name of the actor file without an extension.
+     *  \param position The position to place the actor at.
+     *  \return The spawned actor.
+     */
+    Actor spawn(const std::string& filename, const Vector2& position);
+
+    /*
+     *  \func despawn
+     *  \brief Returns a spawned actor to its pool at the end of the
+     *         current frame. Actors that were not spawned from a pool are
+     *         destroyed instead.
+     *
+     *  \param actor The actor to despawn.
+     */
+    void despawn(const Actor& actor);
+
+    /*
+     *  \func addQuery
+     *  \brief Gets a query for every active actor with the given
+     *         components and tags. The results are cached and kept up to
+     *         date as actors are added, removed, spawned and despawned.
+     *
+     *  \param components The ComponentStore bits of required components.
+     *  \param tags The names of required tags.
+     *  \return The index of the query.
+     */
+    size_t addQuery(ComponentMask components,
+                    const std::vector<std::string>& tags);
+
+    /*
+     *  \func getQueryResults
+     *  \brief Gets the actors that currently match a query.
+     *
+     *  \param query The index of the query.
+     *  \return The handles of the matching actors.
+     */
+    inline const std::vector<ActorHandle>& getQueryResults(size_t query) const
+    {
+        return mComponents.getQueryResults(query);
+    }
+
+    /*
+     *  \func getQueryCount
+     *  \brief Gets the number of queries that have been added.
+     *
+     *  \return The number of queries.
+     */
+    inline size_t getQueryCount() const
+    {
+        return mComponents.getQueryCount();
+    }
+
+    /*
+     *  \func getEvents
+     *  \brief Gets the bus used to send events between actors. Events are
+     *         delivered once per frame after the simulation has stepped.
+     *         Physics contacts are sent to both actors as "contact begin"
+     *         and "contact end" events with the impulse as the value and
+     *         the contact point as the position.
+     *
+     *  \return The event bus.
+     */
+    inline EventBus& getEvents()
+    {
+        return mEvents;
+    }
+
+    /*
+     *  \func getPhysics
+     *  \brief Gets the physics world.
+     *
+     *  \return The physics.
      */
-    Actor& addActor(const std::string& filename);
+    inline Physics& getPhysics()
+    {
+        return mPhysics;
+    }
+
+    /*
+     *  \func getArena
+     *  \brief Gets the arena that per map objects are allocated from.
+     *
+     *  \return The map arena.
+     */
+    inline const Arena& getArena() const
+    {
+        return mArena;
+    }
+
+    /*
+     *  \func getActor
+     *  \brief Gets an actor from its handle. The handle is only checked
+     *         when the actor is used.
+     *
+     *  \param handle The handle of the actor.
+     *  \return The actor.
+     */
+    inline Actor getActor(ActorHandle handle)
+    {
+        return Actor(mComponents, handle);
+    }
 
     /*
      *  \func addGUI
@@ -133,6 +302,19 @@ public:
         return Logger::getRegisteredLogger();
     }
 
+    /*
+     *  \func getProfiler
+     *  \brief Returns the profiler the engine records into. The
+     *         scripting layer is a separate binary with its own registered
+     *         profiler, so it must read samples through this.
+     *
+     *  \return The Profiler object.
+     */
+    Profiler& getProfiler()
+    {
+        return mProfiler;
+    }
+
     /*
      *  \func getCamera
      *  \brief Gets the camera instance.
@@ -147,18 +329,40 @@ public:
 private:
     void reset();
 
-    bool tick(double deltaTime);
+    bool tick(double frameTime);
 
-    Sprite& addSprite(const std::string& filename);
+    void step(double deltaTime);
+
+    void destroyPendingActors();
+
+    void postContacts();
+
+    void despawnPendingActors();
+
+    size_t getPool(const std::string& filename);
+
+    void setActorActive(size_t id, bool active);
+
+    Actor addActor(const Prefab& prefab);
+
+    void mergeStaticTiles(const std::vector<ActorHandle>& handles);
+
+    void setComponentsActive(size_t id, bool active);
 
     Config mConfig;
+    Profiler mProfiler;
     bool mRenderPhysics;
 
     sf::Clock mTimer;
     double mElapsedTime;
     const double mTimePerFrame;
+    double mAccumulator;
+    const double mTimePerStep;
     Input mInput;
 
+    // Memory for objects that live as long as a map
+    Arena mArena;
+
     // Graphics
     Graphics mGraphics;
 
@@ -172,10 +376,15 @@ private:
     Camera mCamera;
 
     // Containers
-    std::vector<std::unique_ptr<Actor> > mActors;
+    ComponentStore mComponents;
+    std::vector<ActorHandle> mPendingDestroy;
+    std::vector<ActorHandle> mPendingDespawn;
+    std::vector<ActorHandle> mFamily;
+    std::vector<std::vector<ActorHandle> > mPools;
+    std::unordered_map<std::string, size_t> mPoolIndices;
+    PrefabCache mPrefabs;
+    EventBus mEvents;
     std::map<int32_t, tgui::Gui> mGui;
-
-    std::vector<Actor*> mDynamicActors;
 };
 }
 
@@ -0,0 +1,161 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#ifndef NYRA_EVENT_BUS_H_
+#define NYRA_EVENT_BUS_H_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <nyra/AutoPy.h>
+#include <nyra/ActorHandle.h>
+#include <nyra/Vector2.h>
+#include <nyra/ComponentStore.h>
+
+namespace nyra
+{
+/*
+ *  \class Event
+ *  \brief A message sent to one actor. The payload is a fixed size so
+ *         events can be queued without allocating.
+ */
+struct Event
+{
+    /*
+     *  \var type
+     *  \brief The type of event from EventBus::getType.
+     */
+    size_t type;
+
+    /*
+     *  \var target
+     *  \brief The actor the event is delivered to.
+     */
+    ActorHandle target;
+
+    /*
+     *  \var source
+     *  \brief The actor that sent the event or INVALID_ACTOR.
+     */
+    ActorHandle source;
+
+    /*
+     *  \var value
+     *  \brief A number whose meaning depends on the type of event.
+     */
+    double value;
+
+    /*
+     *  \var position
+     *  \brief A position whose meaning depends on the type of event.
+     */
+    Vector2 position;
+};
+
+/*
+ *  \class EventBus
+ *  \brief Queues events between actors and delivers them once per frame.
+ *         Every script receives all of its events for the frame in one
+ *         call to its "events" method as a list of
+ *         (type, source, value, x, y) tuples. Events posted while events
+ *         are being delivered wait for the next frame.
+ */
+class EventBus
+{
+public:
+    /*
+     *  \func Constructor
+     *  \brief Creates an empty bus.
+     */
+    EventBus();
+
+    /*
+     *  \func getType
+     *  \brief Gets the type of an event from its name. Each new name is
+     *         given the next type.
+     *
+     *  \param name The name of the event.
+     *  \return The type of the event.
+     */
+    size_t getType(const std::string& name);
+
+    /*
+     *  \func post
+     *  \brief Queues an event for delivery at the end of the frame.
+     *
+     *  \param event The event to queue.
+     */
+    inline void post(const Event& event)
+    {
+        mQueue.push_back(event);
+    }
+
+    /*
+     *  \func post
+     *  \brief Queues a copy of an event for each actor in a list.
+     *
+     *  \param event The event to queue. The target is ignored.
+     *  \param targets The actors to send the event to.
+     */
+    void post(const Event& event,
+              const std::vector<ActorHandle>& targets);
+
+    /*
+     *  \func dispatch
+     *  \brief Delivers every queued event to the scripts of its target.
+     *         Events for actors that are destroyed, inactive or have no
+     *         events method are dropped.
+     *
+     *  \param components The store used to find the target scripts.
+     *  \throw If the events cannot be converted to Python or a script
+     *         raises an error.
+     */
+    void dispatch(ComponentStore& components);
+
+    /*
+     *  \func clear
+     *  \brief Drops every queued event. Event types are kept.
+     */
+    void clear();
+
+    /*
+     *  \func getSize
+     *  \brief Gets the number of queued events.
+     *
+     *  \return The number of events.
+     */
+    inline size_t getSize() const
+    {
+        return mQueue.size();
+    }
+
+private:
+    std::vector<Event> mQueue;
+    std::vector<Event> mDispatching;
+    std::vector<size_t> mOrder;
+    std::unordered_map<std::string, size_t> mTypes;
+    std::vector<AutoPy> mTypeNames;
+};
+}
+
+#endif
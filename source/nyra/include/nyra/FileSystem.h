@@ -45,6 +45,17 @@ std::string readFile(const std::string& pathname);
  *  \return True if the file exists at the location.
  */
 bool fileExists(const std::string& pathname);
+
+/*
+ *  \func canonicalPath
+ *  \brief Resolves a pathname to an absolute path with no symbolic links
+ *         or relative components.
+ *
+ *  \param pathname The pathname to resolve.
+ *  \return The canonical pathname.
+ *  \throw If the file does not exist.
+ */
+std::string canonicalPath(const std::string& pathname);
 }
 
 #endif
\ No newline at end of file
@@ -26,8 +26,14 @@
 
 #include <string>
 #include <memory>
+#include <thread>
+#include <mutex>
+#include <stdint.h>
+#include <condition_variable>
 #include <nyra/Vector2.h>
 #include <nyra/Sprite.h>
+#include <nyra/TextureManager.h>
+#include <nyra/SpatialGrid.h>
 #include <SFML/Graphics.hpp>
 
 namespace nyra
@@ -48,16 +54,30 @@ public:
      *  \param size The size of the client area of the window.
      *  \param fullscreen Should the window be fullscreen?
      *  \param vsync Should the graphics use vsync?
+     *  \param headless If true no window is created and all drawing
+     *         becomes a no-op.
+     *  \param pipelined If true drawing is done on a separate render
+     *         thread from a snapshot of the sprites. This is ignored when
+     *         headless.
      */
     Graphics(const std::string& title,
              const Vector2& position,
              const Vector2& size,
              bool fullscreen,
-             bool vsync);
+             bool vsync,
+             bool headless,
+             bool pipelined);
+
+    /*
+     *  \func Destructor
+     *  \brief Stops the render thread if one is running.
+     */
+    ~Graphics();
 
     /*
      *  \func clear
      *  \brief Updates the window and clears the buffer to prepare for drawing.
+     *         When pipelined this only handles window events.
      *
      *  \return False if the window was closed. If it was closed then drawing
      *          should not be done.
@@ -66,24 +86,29 @@ public:
 
     /*
      *  \func render
-     *  \brief Renders all managed sprites to the screen.
+     *  \brief Renders all managed sprites to the screen. Consecutive sprites
+     *         that share a texture are drawn with a single vertex array.
+     *         Only sprites that changed since the last frame have their
+     *         vertices rewritten. When pipelined this instead copies the
+     *         vertex arrays and view into the back snapshot.
      */
     void render();
 
     /*
      *  \func present
-     *  \brief Updates the window with the contents of the back buffer.
+     *  \brief Updates the window with the contents of the back buffer. When
+     *         pipelined this hands the back snapshot to the render thread,
+     *         waiting for it to finish the previous frame first. Nothing
+     *         is handed over once the render thread has stopped.
      */
     void present();
 
     /*
      *  \func reset
      *  \brief Resets the state of the graphics to when it was first created.
+     *         Textures that are no longer used are released.
      */
-    inline void reset()
-    {
-        mSprites.clear();
-    }
+    void reset();
 
     /*
      *  \func getVsyncFlag
@@ -96,18 +121,120 @@ public:
         return mVsync;
     }
 
+    /*
+     *  \func getHeadlessFlag
+     *  \brief Returns whether the renderer is running without a window.
+     *
+     *  \return True if there is no window
+     */
+    inline bool getHeadlessFlag() const
+    {
+        return mHeadless;
+    }
+
+    /*
+     *  \func getPipelinedFlag
+     *  \brief Returns whether drawing happens on a separate render thread.
+     *         When this is true the window must not be drawn to directly.
+     *
+     *  \return True if the renderer is pipelined
+     */
+    inline bool getPipelinedFlag() const
+    {
+        return mPipelined;
+    }
+
     /*
      *  \func addSprite
      *  \brief Creates a new sprite object and adds it as a managed object.
+     *         The texture is shared with any other sprite using the same
+     *         image.
      *
      *  \param pathname The full pathname to the sprite image.
-     *  \return The sprite object that was created.
+     *  \return The index of the sprite that was created.
+     */
+    size_t addSprite(const std::string& pathname);
+
+    /*
+     *  \func addSprite
+     *  \brief Creates a new sprite from a texture that was already looked
+     *         up. This skips the texture cache lookup.
+     *
+     *  \param texture The texture region to draw.
+     *  \return The index of the sprite that was created.
+     */
+    size_t addSprite(const TextureRegion& texture);
+
+    /*
+     *  \func getTexture
+     *  \brief Looks up a texture through the texture cache.
+     *
+     *  \param pathname The full pathname to the image.
+     *  \return The texture region of the image.
+     */
+    inline TextureRegion getTexture(const std::string& pathname)
+    {
+        return mTextures.get(pathname);
+    }
+
+    /*
+     *  \func reserveSprites
+     *  \brief Makes room for more sprites so adding them does not grow
+     *         the sprite and vertex lists one at a time.
+     *
+     *  \param count The number of sprites about to be added.
+     */
+    void reserveSprites(size_t count);
+
+    /*
+     *  \func removeSprite
+     *  \brief Removes a managed sprite. The last sprite is moved into its
+     *         place so the caller must update anything that refers to the
+     *         last index. Sprites are still drawn in the order they were
+     *         added.
+     *
+     *  \param index The index of the sprite to remove.
+     */
+    void removeSprite(size_t index);
+
+    /*
+     *  \func getSpriteCount
+     *  \brief Gets the number of managed sprites.
+     *
+     *  \return The number of sprites.
+     */
+    inline size_t getSpriteCount() const
+    {
+        return mSprites.size();
+    }
+
+    /*
+     *  \func getSprite
+     *  \brief Gets a managed sprite. Sprites are stored contiguously so
+     *         the reference is only valid until the next sprite is added.
+     *
+     *  \param index The index returned by addSprite.
+     *  \return The sprite.
+     */
+    inline Sprite& getSprite(size_t index)
+    {
+        return mSprites[index];
+    }
+
+    /*
+     *  \func loadAtlas
+     *  \brief Loads a texture atlas. Sprites created afterwards from an
+     *         image in the atlas share the atlas page and can be drawn
+     *         together.
+     *
+     *  \param pathname The full pathname to the atlas json file.
      */
-    Sprite& addSprite(const std::string& pathname);
+    void loadAtlas(const std::string& pathname);
 
     /*
      *  \func getWindow
-     *  \brief Gets the underlying native window object.
+     *  \brief Gets the underlying native window object. In headless mode
+     *         this window is never opened.
      *
      *  \return The SFML window.
      */
@@ -116,14 +243,97 @@ public:
         return mWindow;
     }
 
+    /*
+     *  \func getTextures
+     *  \brief Gets the texture cache used for sprites.
+     *
+     *  \return The texture manager.
+     */
+    inline const TextureManager& getTextures() const
+    {
+        return mTextures;
+    }
+
+    /*
+     *  \func getVisibleSpriteCount
+     *  \brief Gets how many sprites were inside the view the last time
+     *         the scene was rendered.
+     *
+     *  \return The number of sprites drawn last frame.
+     */
+    inline size_t getVisibleSpriteCount() const
+    {
+        return mVisible.size();
+    }
+
+    /*
+     *  \func getView
+     *  \brief Gets the view the sprites are drawn with. Changes to this
+     *         are picked up by the next call to render.
+     *
+     *  \return The scene view.
+     */
+    inline sf::View& getView()
+    {
+        return mView;
+    }
+
 private:
+    struct Batch
+    {
+        const sf::Texture* texture;
+        sf::VertexArray vertices;
+    };
+
+    struct Snapshot
+    {
+        sf::View view;
+        std::vector<Batch> batches;
+    };
+
+    void updateSprites();
+
+    void buildBatches();
+
+    void drawBatches(const std::vector<Batch>& batches);
+
+    void renderLoop();
+
+    void waitForRenderThread();
+
+    void stopRenderThread();
+
     sf::Clock mClock;
     size_t mFrames;
     const bool mVsync;
+    const bool mHeadless;
+    const bool mPipelined;
 
     const std::string mWindowTitle;
     sf::RenderWindow mWindow;
-    std::vector<std::unique_ptr<Sprite> > mSprites;
+    sf::View mView;
+    TextureManager mTextures;
+    std::vector<Sprite> mSprites;
+    std::vector<uint64_t> mDrawOrder;
+    uint64_t mNextDrawOrder;
+
+    // Batching and culling
+    std::vector<sf::Vertex> mQuads;
+    std::vector<size_t> mDirtySprites;
+    std::vector<size_t> mVisible;
+    std::vector<Batch> mBatches;
+    SpatialGrid mGrid;
+
+    // Pipelined rendering
+    Snapshot mSnapshots[2];
+    size_t mWriteSnapshot;
+    size_t mReadSnapshot;
+    bool mSnapshotPending;
+    bool mRendering;
+    bool mStopRendering;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::thread mRenderThread;
 };
 }
 
@@ -43,8 +43,11 @@ public:
     /*
      *  \func Constructor
      *  \brief Initializes an Input object.
+     *
+     *  \param headless If true the input devices are never polled and
+     *         every button reports as up.
      */
-    Input();
+    Input(bool headless = false);
 
     /*
      *  \func registerInput
@@ -100,6 +103,7 @@ public:
 private:
     const std::vector<size_t>& getInputs(const std::string& name) const;
 
+    const bool mHeadless;
     std::vector<bool> mKeysPrev;
     std::unordered_map<std::string, std::vector<size_t> > mInputs;
 };
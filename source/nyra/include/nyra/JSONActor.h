@@ -112,6 +112,13 @@ public:
          *  \brief An optional init funciton name.
          */
         const std::unique_ptr<const std::string> init;
+
+        /*
+         *  \var events
+         *  \brief An optional function name that receives the Actor's
+         *         events once per frame.
+         */
+        const std::unique_ptr<const std::string> events;
     };
 
     /*
@@ -186,6 +193,39 @@ public:
         const std::vector<JSONPhysicsShape> shapes;
     };
 
+    /*
+     *  \class JSONChild
+     *  \brief Parses an attached child actor from a json node.
+     */
+    struct JSONChild
+    {
+        /*
+         *  \func Constructor
+         *  \brief Parses a child actor from a json node.
+         *
+         *  \param json The node to parse from.
+         */
+        JSONChild(const JSONNode& json);
+
+        /*
+         *  \var filename
+         *  \brief The name of the child's actor file without an extension.
+         */
+        const std::string filename;
+
+        /*
+         *  \var offset
+         *  \brief An optional position relative to the parent in pixels.
+         */
+        const Vector2 offset;
+
+        /*
+         *  \var rotation
+         *  \brief An optional rotation relative to the parent in degrees.
+         */
+        const double rotation;
+    };
+
 private:
     const JSONReader mReader;
 
@@ -207,6 +247,19 @@ public:
      *  \brief An optional physics object for this Actor.
      */
     const std::unique_ptr<const JSONPhysics> physics;
+
+    /*
+     *  \var children
+     *  \brief An optional list of actors attached to this Actor.
+     */
+    const std::vector<JSONChild> children;
+
+    /*
+     *  \var tags
+     *  \brief An optional list of names that queries can select this
+     *         Actor by.
+     */
+    const std::vector<std::string> tags;
 };
 }
 
@@ -0,0 +1,125 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#ifndef NYRA_JSON_ATLAS_H_
+#define NYRA_JSON_ATLAS_H_
+
+#include <string>
+#include <vector>
+#include <nyra/JSONNode.h>
+#include <nyra/JSONReader.h>
+#include <nyra/Vector2.h>
+
+namespace nyra
+{
+/*
+ *  \class JSONAtlas
+ *  \brief Parses a texture atlas description out of a JSON file. All
+ *         filenames are relative to the directory of the atlas file.
+ */
+struct JSONAtlas
+{
+public:
+    /*
+     *  \func Constructor
+     *  \brief Parses atlas values out of a JSON file
+     *
+     *  \param pathname The pathname to the json file to parse.
+     */
+    JSONAtlas(const std::string& pathname);
+
+    /*
+     *  \class JSONAtlasTexture
+     *  \brief Parses the location of a single packed image.
+     */
+    struct JSONAtlasTexture
+    {
+    public:
+        /*
+         *  \func Constructor
+         *  \brief Parses texture information out of a json node.
+         *
+         *  \param json The node to parse from.
+         */
+        JSONAtlasTexture(const JSONNode& json);
+
+        /*
+         *  \var filename
+         *  \brief The filename of the original image including extension.
+         */
+        const std::string filename;
+
+        /*
+         *  \var position
+         *  \brief The top left of the image within the page in pixels.
+         */
+        const Vector2 position;
+
+        /*
+         *  \var size
+         *  \brief The size of the image in pixels.
+         */
+        const Vector2 size;
+    };
+
+    /*
+     *  \class JSONAtlasPage
+     *  \brief Parses a single page image and the textures packed into it.
+     */
+    struct JSONAtlasPage
+    {
+    public:
+        /*
+         *  \func Constructor
+         *  \brief Parses page information out of a json node.
+         *
+         *  \param json The node to parse from.
+         */
+        JSONAtlasPage(const JSONNode& json);
+
+        /*
+         *  \var filename
+         *  \brief The filename of the page image including extension.
+         */
+        const std::string filename;
+
+        /*
+         *  \var textures
+         *  \brief The images packed into this page.
+         */
+        const std::vector<JSONAtlasTexture> textures;
+    };
+
+private:
+    const JSONReader mReader;
+
+public:
+    /*
+     *  \var pages
+     *  \brief The pages that make up the atlas.
+     */
+    const std::vector<JSONAtlasPage> pages;
+};
+}
+
+#endif
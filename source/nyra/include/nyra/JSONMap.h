@@ -81,6 +81,62 @@ public:
         const double rotation;
     };
 
+    /*
+     *  \class JSONSector
+     *  \brief Parses the box of a physics sector out of a json node.
+     */
+    struct JSONSector
+    {
+    public:
+        /*
+         *  \func Constructor
+         *  \brief Parses sector information out of a json node.
+         *
+         *  \param json The node to parse from.
+         */
+        JSONSector(const JSONNode& json);
+
+        /*
+         *  \var lower
+         *  \brief The top left of the sector.
+         */
+        const Vector2 lower;
+
+        /*
+         *  \var upper
+         *  \brief The bottom right of the sector.
+         */
+        const Vector2 upper;
+    };
+
+    /*
+     *  \class JSONPoolInstance
+     *  \brief Parses how many of an actor to prewarm out of a json node.
+     */
+    struct JSONPoolInstance
+    {
+    public:
+        /*
+         *  \func Constructor
+         *  \brief Parses pool information out of a json node.
+         *
+         *  \param json The node to parse from.
+         */
+        JSONPoolInstance(const JSONNode& json);
+
+        /*
+         *  \var filename
+         *  \brief The name of the actor file without an extension.
+         */
+        const std::string filename;
+
+        /*
+         *  \var count
+         *  \brief The number of inactive actors to create.
+         */
+        const size_t count;
+    };
+
 private:
     const JSONReader mReader;
 
@@ -91,6 +147,19 @@ public:
      */
     const std::vector<JSONActorInstance> actors;
 
+    /*
+     *  \var pools
+     *  \brief An optional list of actor pools to fill when the map loads.
+     */
+    const std::vector<JSONPoolInstance> pools;
+
+    /*
+     *  \var sectors
+     *  \brief An optional list of boxes that are each simulated as their
+     *         own physics world.
+     */
+    const std::vector<JSONSector> sectors;
+
 };
 }
 
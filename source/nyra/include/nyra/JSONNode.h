@@ -113,6 +113,19 @@ public:
                        const std::string& x = "x",
                        const std::string& y = "y") const;
 
+    /*
+     *  \func getStringArray
+     *  \brief Extract a vector of strings. This also supports extracting
+     *         a single string, in which case a vector of length 1 is
+     *         created.
+     *
+     *  \param name The name of the array.
+     *  \return The strings in the array.
+     *  \throw If the array does not exist or holds something other than
+     *         strings.
+     */
+    std::vector<std::string> getStringArray(const std::string& name) const;
+
     /*
      *  \func getArray
      *  \brief Extract a vector of some type of JSON object. This requires
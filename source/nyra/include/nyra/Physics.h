@@ -30,15 +30,61 @@
 #include <Box2D/Box2D.h>
 #include <nyra/PhysicsBody.h>
 #include <nyra/PhysicsRenderer.h>
+#include <nyra/Arena.h>
+#include <nyra/PhysicsSettings.h>
+#include <nyra/PhysicsStats.h>
+#include <nyra/ContactListener.h>
+#include <nyra/WorkerPool.h>
 
 namespace nyra
 {
+/*
+ *  \class RayHit
+ *  \brief The first thing a ray or cast touched.
+ */
+struct RayHit
+{
+    /*
+     *  \var hit
+     *  \brief True if anything was touched. The rest is only set if it was.
+     */
+    bool hit;
+
+    /*
+     *  \var actor
+     *  \brief The actor that was touched. This is INVALID_ACTOR for bodies
+     *         without an actor such as merged map tiles.
+     */
+    ActorHandle actor;
+
+    /*
+     *  \var point
+     *  \brief Where it was touched in pixels.
+     */
+    Vector2 point;
+
+    /*
+     *  \var normal
+     *  \brief The surface normal where it was touched.
+     */
+    Vector2 normal;
+
+    /*
+     *  \var fraction
+     *  \brief How far along from the start to the end it was touched
+     *         (0 - 1).
+     */
+    double fraction;
+};
+
 /*
  *  \class Physics
  *  \brief Top level wrapper class for Box2D. This holds the world and manages
  *         physics bodies. This wrapper is updated on a step based timer
  *         and thus may update at a slightly different rate than the rest of
- *         the game.
+ *         the game. The world can be split into sectors that each have
+ *         their own Box2D world and are stepped at the same time. Bodies in
+ *         different sectors never touch.
  */
 class Physics
 {
@@ -50,20 +96,89 @@ public:
      *  \param gravity The gravity in meters per second squared. Note that
      *         (0, 0) is the top left meaning downward acceleration is
      *         in the positive y direction.
+     *  \param settings How the world is solved.
+     *  \param threads The number of worker threads used to step sectors.
      *  \param renderer The physics renderer object used to draw collision
      *         objects to screen for debug purposes.
+     *  \param arena The map arena that bodies are allocated from.
      */
     Physics(const Vector2& gravity,
-            PhysicsRenderer& renderer);
+            const PhysicsSettings& settings,
+            size_t threads,
+            PhysicsRenderer& renderer,
+            Arena& arena);
+
+    /*
+     *  \func setSettings
+     *  \brief Changes how the world is solved. This takes effect on the
+     *         next step.
+     *
+     *  \param settings The new settings.
+     *  \throw If there are no sub steps.
+     */
+    void setSettings(const PhysicsSettings& settings);
+
+    /*
+     *  \func getSettings
+     *  \brief Gets how the world is solved.
+     *
+     *  \return The current settings.
+     */
+    inline const PhysicsSettings& getSettings() const
+    {
+        return mSettings;
+    }
+
+    /*
+     *  \func getStats
+     *  \brief Gets what the last update cost and how busy the world is.
+     *
+     *  \return The stats of the last update.
+     */
+    inline const PhysicsStats& getStats() const
+    {
+        return mStats;
+    }
+
+    /*
+     *  \func setSectors
+     *  \brief Splits the world into sectors. Each box is stepped as its
+     *         own world, which can happen on its own thread. Everything
+     *         outside of every box is in one more sector. Bodies move
+     *         between sectors when they are added or moved from outside
+     *         of the step and when they leave the box of their sector
+     *         while awake, so sectors should only meet where bodies
+     *         cannot be touching anything across the border.
+     *
+     *  \param corners The top left and bottom right of each box in pixels
+     *         one after the other.
+     *  \throw If there are bodies or the corners are not in pairs.
+     */
+    void setSectors(const std::vector<Vector2>& corners);
+
+    /*
+     *  \func getSectorCount
+     *  \brief Gets the number of sectors including the one outside of
+     *         every box.
+     *
+     *  \return The number of sectors.
+     */
+    inline size_t getSectorCount() const
+    {
+        return mSectors.size();
+    }
 
     /*
      *  \func update
-     *  \brief Update all physics. Note that this is not guarenteed to update
-     *         anything if the game is running faster than the physics. The
-     *         opposite can also occur. If the game is running slow, then the
-     *         physics may update multiple times to catch up.
+     *  \brief Steps all physics forward by deltaTime. The engine calls this
+     *         with a fixed step and may call it several times in one frame
+     *         to catch up. New and awake bodies are first moved to the
+     *         sector they are in and the sectors are then stepped on the
+     *         worker threads. The transform of each awake body before the
+     *         step is kept so graphics can be blended between steps. Bodies
+     *         woken by touching an awake body are added to the awake list.
      *
-     *  \param deltaTime The time since the last update in seconds.
+     *  \param deltaTime The time to step in seconds.
      */
     void update(double deltaTime);
 
@@ -83,17 +198,228 @@ public:
     PhysicsBody& addBody(PhysicsBody::Type type);
 
     /*
-     *  \func render
-     *  \brief Renders debug physics object to screen if they are enabled.
+     *  \func reserve
+     *  \brief Makes room for more bodies so adding them does not grow the
+     *         list one at a time.
+     *
+     *  \param count The number of bodies about to be added.
      */
-    inline void render()
+    inline void reserve(size_t count)
     {
-        mWorld.DrawDebugData();
+        mBodies.reserve(mBodies.size() + count);
+        mAwake.reserve(mAwake.size() + count);
     }
 
+    /*
+     *  \func removeBody
+     *  \brief Destroys a managed physics body. This must not be called
+     *         while the world is stepping.
+     *
+     *  \param body The body to destroy. It is no longer valid after this.
+     */
+    void removeBody(PhysicsBody& body);
+
+    /*
+     *  \func canMerge
+     *  \brief Checks if a body is static, unrotated and made only of
+     *         solid axis aligned boxes, which is what level tiles are.
+     *
+     *  \param body The body to check.
+     *  \return True if the body can be passed to mergeStaticBoxes.
+     */
+    static bool canMerge(const PhysicsBody& body);
+
+    /*
+     *  \func mergeStaticBoxes
+     *  \brief Replaces many static boxes with the outline of the area they
+     *         cover. Touching and overlapping boxes with the same friction
+     *         are joined and their outlines are added as chain loops to a
+     *         single static body. This removes the seams bodies can catch
+     *         on and leaves far fewer proxies in the broadphase. Chains
+     *         are hollow, so anything that starts inside the merged area
+     *         is not pushed out.
+     *
+     *  \param bodies The bodies to merge. Each must pass canMerge. They are
+     *         destroyed and are no longer valid after this.
+     */
+    void mergeStaticBoxes(const std::vector<PhysicsBody*>& bodies);
+
+    /*
+     *  \func getAwakeBodies
+     *  \brief Gets the bodies that may have moved since they were last
+     *         pruned. Sleeping bodies stay in the list until their final
+     *         resting transform has been synced.
+     *
+     *  \return The awake bodies.
+     */
+    inline const std::vector<PhysicsBody*>& getAwakeBodies() const
+    {
+        return mAwake;
+    }
+
+    /*
+     *  \func pruneAwakeBodies
+     *  \brief Removes bodies that have fallen asleep and settled or that
+     *         are inactive from the awake list. This should be called after
+     *         the awake bodies have been synced for the frame.
+     */
+    void pruneAwakeBodies();
+
+    /*
+     *  \func rayCast
+     *  \brief Finds the closest body a line passes through. Sensors are
+     *         ignored.
+     *
+     *  \param start The start of the line in pixels.
+     *  \param end The end of the line in pixels.
+     *  \param hit Filled with what was hit.
+     *  \return True if anything was hit.
+     */
+    bool rayCast(const Vector2& start,
+                 const Vector2& end,
+                 RayHit& hit) const;
+
+    /*
+     *  \func rayCast
+     *  \brief Casts many rays at once.
+     *
+     *  \param points The start and end of each ray one after the other.
+     *  \param hits Filled with one hit for each ray.
+     *  \throw If the points are not in pairs.
+     */
+    void rayCast(const std::vector<Vector2>& points,
+                 std::vector<RayHit>& hits) const;
+
+    /*
+     *  \func circleCast
+     *  \brief Finds the first body a moving circle touches. This is used
+     *         to check if something with a size fits along a path.
+     *         Sensors are ignored.
+     *
+     *  \param start The start of the path of the center in pixels.
+     *  \param end The end of the path of the center in pixels.
+     *  \param radius The radius of the circle in pixels.
+     *  \param hit Filled with what was hit. The point is on the surface of
+     *         the body.
+     *  \return True if anything was hit.
+     */
+    bool circleCast(const Vector2& start,
+                    const Vector2& end,
+                    double radius,
+                    RayHit& hit) const;
+
+    /*
+     *  \func circleCast
+     *  \brief Casts many circles at once.
+     *
+     *  \param points The start and end of each path one after the other.
+     *  \param radii The radius of each circle in pixels.
+     *  \param hits Filled with one hit for each circle.
+     *  \throw If the points are not in pairs or there is not a radius for
+     *         every pair.
+     */
+    void circleCast(const std::vector<Vector2>& points,
+                    const std::vector<double>& radii,
+                    std::vector<RayHit>& hits) const;
+
+    /*
+     *  \func queryBox
+     *  \brief Finds the actors with a body that overlaps a box. Sensors
+     *         and bodies without an actor are ignored.
+     *
+     *  \param lower The top left of the box in pixels.
+     *  \param upper The bottom right of the box in pixels.
+     *  \param actors The actors are appended here. Each is added once.
+     */
+    void queryBox(const Vector2& lower,
+                  const Vector2& upper,
+                  std::vector<ActorHandle>& actors) const;
+
+    /*
+     *  \func queryBox
+     *  \brief Queries many boxes at once.
+     *
+     *  \param corners The top left and bottom right of each box one after
+     *         the other.
+     *  \param actors The actors of every box are appended here.
+     *  \param offsets Filled with where the actors of each box start in
+     *         actors, followed by the end of the last box.
+     *  \throw If the corners are not in pairs.
+     */
+    void queryBox(const std::vector<Vector2>& corners,
+                  std::vector<ActorHandle>& actors,
+                  std::vector<size_t>& offsets) const;
+
+    /*
+     *  \func getContacts
+     *  \brief Gets the bodies that started or stopped touching since the
+     *         contacts were last cleared. Contacts ended by removing a body
+     *         are added by the next update.
+     *
+     *  \return The contacts of each sector in the order they happened.
+     */
+    inline const std::vector<Contact>& getContacts() const
+    {
+        return mContacts;
+    }
+
+    /*
+     *  \func clearContacts
+     *  \brief Drops the recorded contacts once they have been handled.
+     */
+    inline void clearContacts()
+    {
+        mContacts.clear();
+    }
+
+    /*
+     *  \func render
+     *  \brief Renders debug physics object to screen if they are enabled.
+     */
+    void render();
+
 private:
-    b2World mWorld;
-    std::vector<std::unique_ptr<PhysicsBody> > mBodies;
+    struct Sector
+    {
+        Sector(const b2Vec2& gravity);
+
+        // The listener must outlive the world so bodies destroyed with it
+        // can still report their contacts ending
+        ContactListener contacts;
+        b2World world;
+        b2AABB bounds;
+        PhysicsStats stats;
+    };
+
+    void addSector();
+
+    size_t findSector(const b2Vec2& position) const;
+
+    void placeBodies();
+
+    void placeBody(PhysicsBody& body);
+
+    PhysicsBody& createBody(PhysicsBody::Type type, size_t sector);
+
+    void removeAwake(PhysicsBody& body);
+
+    bool circleCast(const b2Vec2& start,
+                    const b2Vec2& end,
+                    float32 radius,
+                    std::vector<b2Fixture*>& candidates,
+                    RayHit& hit) const;
+
+    const b2Vec2 mGravity;
+    PhysicsRenderer& mRenderer;
+    PhysicsSettings mSettings;
+    PhysicsStats mStats;
+    WorkerPool mWorkers;
+    std::vector<std::unique_ptr<Sector> > mSectors;
+    ArenaPool<PhysicsBody> mBodyPool;
+    std::vector<PhysicsBody*> mBodies;
+    std::vector<PhysicsBody*> mAwake;
+    std::vector<PhysicsBody*> mUnplaced;
+    std::vector<Contact> mContacts;
 };
 }
 
@@ -27,6 +27,8 @@
 #include <Box2D/Box2D.h>
 #include <nyra/Vector2.h>
 #include <nyra/Constants.h>
+#include <nyra/MathUtils.h>
+#include <nyra/ActorHandle.h>
 #include <vector>
 
 namespace nyra
@@ -49,6 +51,7 @@ public:
     enum Type
     {
         STATIC,
+        KINEMATIC,
         DYNAMIC
     };
 
@@ -75,6 +78,19 @@ public:
                 float density,
                 float friction);
 
+    /*
+     *  \func addShape
+     *  \brief Adds a solid shape to the physics body. The shape is copied
+     *         so one shape can be shared by many bodies.
+     *
+     *  \param shape The shape in meters.
+     *  \param density The density of the object.
+     *  \param friction The friction of the object.
+     */
+    void addShape(const b2Shape& shape,
+                  float density,
+                  float friction);
+
     /*
      *  \func addCircle
      *  \brief Adds a circle collision to the physics body.
@@ -109,10 +125,52 @@ public:
         return mBody->GetAngle() * Constants::RADIANS_TO_DEGREES;
     }
 
+    /*
+     *  \func getInterpolatedPosition
+     *  \brief Blends the position from before the last step with the
+     *         current position.
+     *
+     *  \param alpha How far to blend from the previous position (0 - 1).
+     *  \return The blended position.
+     */
+    inline Vector2 getInterpolatedPosition(double alpha) const
+    {
+        const Vector2 previous(mPrevPosition);
+        return (previous + (Vector2(mBody->GetPosition()) - previous) *
+                alpha) * Constants::PIXELS_PER_METER;
+    }
+
+    /*
+     *  \func getInterpolatedRotation
+     *  \brief Blends the rotation from before the last step with the
+     *         current rotation.
+     *
+     *  \param alpha How far to blend from the previous rotation (0 - 1).
+     *  \return The blended rotation in degrees.
+     */
+    inline float getInterpolatedRotation(double alpha) const
+    {
+        return lerp<double>(mPrevAngle, mBody->GetAngle(), alpha) *
+                Constants::RADIANS_TO_DEGREES;
+    }
+
+    /*
+     *  \func storeTransform
+     *  \brief Saves the current transform so it can be blended with the
+     *         result of the next step. This should only be called
+     *         internally before the world is stepped.
+     */
+    inline void storeTransform()
+    {
+        mPrevPosition = mBody->GetPosition();
+        mPrevAngle = mBody->GetAngle();
+    }
+
     /*
      *  \func setPosition
      *  \brief Sets the position of the physics body. Note that this ignores
-     *         physics calculations.
+     *         physics calculations. The body will not be blended from
+     *         its old position.
      *
      *  \param position The desired position.
      */
@@ -121,6 +179,73 @@ public:
         mBody->SetTransform(
                 (position * Constants::METERS_PER_PIXEL).toThirdParty<b2Vec2>(),
                 mBody->GetAngle());
+        storeTransform();
+        wake();
+        unplace();
+    }
+
+    /*
+     *  \func setTransform
+     *  \brief Moves the body to a transform it is driven to from outside
+     *         of the simulation, such as following a parent actor. The
+     *         body is not woken and will not be blended from its old
+     *         transform.
+     *
+     *  \param position The desired position in pixels.
+     *  \param rotation The desired rotation in degrees.
+     */
+    inline void setTransform(const Vector2& position, double rotation)
+    {
+        mBody->SetTransform(
+                (position * Constants::METERS_PER_PIXEL).toThirdParty<b2Vec2>(),
+                rotation * Constants::DEGREES_TO_RADIANS);
+        storeTransform();
+        unplace();
+    }
+
+    /*
+     *  \func resetMotion
+     *  \brief Stops the body and clears its rotation so it can be reused
+     *         as if it were new.
+     */
+    inline void resetMotion()
+    {
+        mBody->SetLinearVelocity(b2Vec2(0.0f, 0.0f));
+        mBody->SetAngularVelocity(0.0f);
+        mBody->SetTransform(mBody->GetPosition(), 0.0f);
+        storeTransform();
+        wake();
+    }
+
+    /*
+     *  \func wake
+     *  \brief Wakes the body and adds it to the awake list so its sprite is
+     *         synced again. Anything that moves a body outside of the
+     *         physics step should call this. Static bodies never move and
+     *         are ignored.
+     */
+    void wake();
+
+    /*
+     *  \func unplace
+     *  \brief Adds the body to the unplaced list so it is put in the
+     *         sector it belongs to before the next step. Anything that
+     *         moves a body outside of the physics step should call this,
+     *         since bodies that are not awake are not checked otherwise.
+     */
+    void unplace();
+
+    /*
+     *  \func isSettled
+     *  \brief Checks if the body has not moved since its transform was
+     *         last stored.
+     *
+     *  \return True if the body is where it was before the last step.
+     */
+    inline bool isSettled() const
+    {
+        return mPrevPosition == mBody->GetPosition() &&
+               mPrevAngle == mBody->GetAngle();
     }
 
     /*
@@ -145,8 +270,192 @@ public:
         return *mBody;
     }
 
+    /*
+     *  \func getIndex
+     *  \brief Gets the position of this object in its owner's list. This
+     *         should only be used internally.
+     *
+     *  \return The index.
+     */
+    inline size_t getIndex() const
+    {
+        return mIndex;
+    }
+
+    /*
+     *  \func setIndex
+     *  \brief Records the position of this object in its owner's list so
+     *         it can be removed without a search. This should only be
+     *         called internally.
+     *
+     *  \param index The index.
+     */
+    inline void setIndex(size_t index)
+    {
+        mIndex = index;
+    }
+
+    /*
+     *  \func setAwakeList
+     *  \brief Sets the list this body adds itself to when woken. This
+     *         should only be called internally.
+     *
+     *  \param list The awake list of the owning physics.
+     */
+    inline void setAwakeList(std::vector<PhysicsBody*>* list)
+    {
+        mAwakeList = list;
+    }
+
+    /*
+     *  \func setUnplacedList
+     *  \brief Sets the list this body adds itself to when it needs to be
+     *         placed. This should only be called internally.
+     *
+     *  \param list The unplaced list of the owning physics.
+     */
+    inline void setUnplacedList(std::vector<PhysicsBody*>* list)
+    {
+        mUnplacedList = list;
+    }
+
+    /*
+     *  \func getUnplacedIndex
+     *  \brief Gets the position of this object in the unplaced list. This
+     *         is only valid while the body is not placed and should only
+     *         be used internally.
+     *
+     *  \return The index.
+     */
+    inline size_t getUnplacedIndex() const
+    {
+        return mUnplacedIndex;
+    }
+
+    /*
+     *  \func setUnplacedIndex
+     *  \brief Records the position of this object in the unplaced list.
+     *         This should only be called internally.
+     *
+     *  \param index The index.
+     */
+    inline void setUnplacedIndex(size_t index)
+    {
+        mUnplacedIndex = index;
+    }
+
+    /*
+     *  \func getAwakeIndex
+     *  \brief Gets the position of this object in the awake list. This
+     *         should only be used internally.
+     *
+     *  \return The index or NOT_AWAKE.
+     */
+    inline size_t getAwakeIndex() const
+    {
+        return mAwakeIndex;
+    }
+
+    /*
+     *  \func setAwakeIndex
+     *  \brief Records the position of this object in the awake list. This
+     *         should only be called internally.
+     *
+     *  \param index The index or NOT_AWAKE.
+     */
+    inline void setAwakeIndex(size_t index)
+    {
+        mAwakeIndex = index;
+    }
+
+    /*
+     *  \func setActor
+     *  \brief Records which actor this body belongs to.
+     *
+     *  \param actor The handle of the actor.
+     */
+    inline void setActor(ActorHandle actor)
+    {
+        mActor = actor;
+    }
+
+    /*
+     *  \func getActor
+     *  \brief Gets the actor this body belongs to.
+     *
+     *  \return The handle of the actor or INVALID_ACTOR.
+     */
+    inline ActorHandle getActor() const
+    {
+        return mActor;
+    }
+
+    /*
+     *  \func moveTo
+     *  \brief Moves the body into another world. The Box2D body is
+     *         recreated there with the same fixtures, transform and motion.
+     *         Any contacts in the old world end. This should only be
+     *         called internally.
+     *
+     *  \param world The world to move to.
+     *  \param sector The index of the sector that owns the world.
+     */
+    void moveTo(b2World& world, size_t sector);
+
+    /*
+     *  \func getSector
+     *  \brief Gets the sector whose world holds this body.
+     *
+     *  \return The index of the sector.
+     */
+    inline size_t getSector() const
+    {
+        return mSector;
+    }
+
+    /*
+     *  \func isPlaced
+     *  \brief Checks if the body has been put in the sector it belongs
+     *         to. Bodies are placed before the next step after they are
+     *         added or moved. This should only be used internally.
+     *
+     *  \return True if the body has been placed.
+     */
+    inline bool isPlaced() const
+    {
+        return mPlaced;
+    }
+
+    /*
+     *  \func setPlaced
+     *  \brief Records whether the body has been placed. This should only
+     *         be called internally.
+     *
+     *  \param placed True if the body has been placed.
+     */
+    inline void setPlaced(bool placed)
+    {
+        mPlaced = placed;
+    }
+
+    /*
+     *  \var NOT_AWAKE
+     *  \brief The awake index of a body that is not in the awake list.
+     */
+    static const size_t NOT_AWAKE;
+
 private:
     b2Body* mBody;
+    b2Vec2 mPrevPosition;
+    float32 mPrevAngle;
+    size_t mIndex;
+    std::vector<PhysicsBody*>* mAwakeList;
+    size_t mAwakeIndex;
+    std::vector<PhysicsBody*>* mUnplacedList;
+    size_t mUnplacedIndex;
+    ActorHandle mActor;
+    size_t mSector;
+    bool mPlaced;
 };
 }
 
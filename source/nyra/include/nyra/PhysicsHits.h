@@ -0,0 +1,77 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#ifndef NYRA_PHYSICS_HITS_H_
+#define NYRA_PHYSICS_HITS_H_
+
+#include <vector>
+#include <stddef.h>
+
+namespace nyra
+{
+/*
+ *  \class PhysicsHits
+ *  \brief The results of a batch of ray or circle casts in flat arrays so
+ *         they cross into Python in one call.
+ */
+struct PhysicsHits
+{
+    /*
+     *  \var actors
+     *  \brief The handle of the actor each cast hit. This is zero if
+     *         nothing was hit or the body has no actor.
+     */
+    std::vector<size_t> actors;
+
+    /*
+     *  \var values
+     *  \brief Five values for each cast: the x and y of the hit point, the
+     *         x and y of the normal and the fraction along the cast. The
+     *         fraction is -1 if nothing was hit.
+     */
+    std::vector<double> values;
+};
+
+/*
+ *  \class PhysicsOverlaps
+ *  \brief The results of a batch of box queries in flat arrays so they
+ *         cross into Python in one call.
+ */
+struct PhysicsOverlaps
+{
+    /*
+     *  \var actors
+     *  \brief The handles of the actors found by every box.
+     */
+    std::vector<size_t> actors;
+
+    /*
+     *  \var offsets
+     *  \brief Where the actors of each box start, followed by the end of
+     *         the last box.
+     */
+    std::vector<size_t> offsets;
+};
+}
+
+#endif
@@ -0,0 +1,92 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#ifndef NYRA_PHYSICS_SETTINGS_H_
+#define NYRA_PHYSICS_SETTINGS_H_
+
+#include <stddef.h>
+
+namespace nyra
+{
+/*
+ *  \class PhysicsSettings
+ *  \brief Controls how accurately and how expensively the physics world is
+ *         solved. These can be changed between steps.
+ */
+struct PhysicsSettings
+{
+    /*
+     *  \func Constructor
+     *  \brief Creates the default settings.
+     */
+    PhysicsSettings() :
+        velocityIterations(8),
+        positionIterations(3),
+        subSteps(1),
+        allowSleeping(true),
+        warmStarting(true),
+        continuousPhysics(true)
+    {
+    }
+
+    /*
+     *  \var velocityIterations
+     *  \brief The number of velocity constraint passes in each step.
+     */
+    size_t velocityIterations;
+
+    /*
+     *  \var positionIterations
+     *  \brief The number of position constraint passes in each step.
+     */
+    size_t positionIterations;
+
+    /*
+     *  \var subSteps
+     *  \brief The number of smaller steps each fixed step is split into.
+     *         More sub steps are more stable but cost more.
+     */
+    size_t subSteps;
+
+    /*
+     *  \var allowSleeping
+     *  \brief Should bodies that come to rest stop being simulated? The
+     *         time and speed a body must rest for are fixed by Box2D.
+     */
+    bool allowSleeping;
+
+    /*
+     *  \var warmStarting
+     *  \brief Should the solver start from the last step's impulses?
+     */
+    bool warmStarting;
+
+    /*
+     *  \var continuousPhysics
+     *  \brief Should fast bodies be checked for tunneling?
+     */
+    bool continuousPhysics;
+};
+}
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#ifndef NYRA_PHYSICS_STATS_H_
+#define NYRA_PHYSICS_STATS_H_
+
+#include <stddef.h>
+
+namespace nyra
+{
+/*
+ *  \class PhysicsStats
+ *  \brief What the last physics update cost. Times are in milliseconds
+ *         and are summed over all sub steps.
+ */
+struct PhysicsStats
+{
+    /*
+     *  \func Constructor
+     *  \brief Creates an empty set of stats.
+     */
+    PhysicsStats() :
+        step(0.0),
+        collide(0.0),
+        solve(0.0),
+        solveInit(0.0),
+        solveVelocity(0.0),
+        solvePosition(0.0),
+        broadphase(0.0),
+        solveTOI(0.0),
+        bodies(0),
+        awakeBodies(0),
+        contacts(0),
+        proxies(0)
+    {
+    }
+
+    /*
+     *  \var step
+     *  \brief The total time spent stepping the world.
+     */
+    double step;
+
+    /*
+     *  \var collide
+     *  \brief The time spent updating contacts.
+     */
+    double collide;
+
+    /*
+     *  \var solve
+     *  \brief The time spent solving islands.
+     */
+    double solve;
+
+    /*
+     *  \var solveInit
+     *  \brief The time spent setting up the solver.
+     */
+    double solveInit;
+
+    /*
+     *  \var solveVelocity
+     *  \brief The time spent on velocity iterations.
+     */
+    double solveVelocity;
+
+    /*
+     *  \var solvePosition
+     *  \brief The time spent on position iterations.
+     */
+    double solvePosition;
+
+    /*
+     *  \var broadphase
+     *  \brief The time spent finding new pairs in the broadphase.
+     */
+    double broadphase;
+
+    /*
+     *  \var solveTOI
+     *  \brief The time spent on continuous collision.
+     */
+    double solveTOI;
+
+    /*
+     *  \var bodies
+     *  \brief The number of bodies in the world.
+     */
+    size_t bodies;
+
+    /*
+     *  \var awakeBodies
+     *  \brief The number of bodies that are awake.
+     */
+    size_t awakeBodies;
+
+    /*
+     *  \var contacts
+     *  \brief The number of contacts, including ones that are not
+     *         touching.
+     */
+    size_t contacts;
+
+    /*
+     *  \var proxies
+     *  \brief The number of broadphase proxies.
+     */
+    size_t proxies;
+};
+}
+
+#endif
@@ -0,0 +1,195 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#ifndef NYRA_PREFAB_H_
+#define NYRA_PREFAB_H_
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <Box2D/Box2D.h>
+#include <SFML/Graphics.hpp>
+#include <nyra/TextureManager.h>
+#include <nyra/PhysicsBody.h>
+#include <nyra/Vector2.h>
+#include <nyra/ComponentStore.h>
+
+namespace nyra
+{
+/*
+ *  \class Prefab
+ *  \brief A parsed and validated actor description. Every instance of an
+ *         actor file shares one of these, so nothing here may change once
+ *         it is built.
+ */
+struct Prefab
+{
+    /*
+     *  \class SpritePrefab
+     *  \brief The texture and origin shared by every instance's sprite.
+     */
+    struct SpritePrefab
+    {
+        /*
+         *  \var texture
+         *  \brief The texture region the sprite draws.
+         */
+        TextureRegion texture;
+
+        /*
+         *  \var origin
+         *  \brief The origin in pixels. This is the center of the texture
+         *         region unless the actor file sets it.
+         */
+        sf::Vector2f origin;
+    };
+
+    /*
+     *  \class ScriptPrefab
+     *  \brief The Python class and methods used by every instance.
+     */
+    struct ScriptPrefab
+    {
+        /*
+         *  \var module
+         *  \brief The name of the Python module.
+         */
+        std::string module;
+
+        /*
+         *  \var className
+         *  \brief The name of the Python class.
+         */
+        std::string className;
+
+        /*
+         *  \var methods
+         *  \brief Pairs of C++ method keys and Python method names.
+         */
+        std::vector<std::pair<std::string, std::string> > methods;
+    };
+
+    /*
+     *  \class ShapePrefab
+     *  \brief A collision shape shared by every instance. Box2D copies the
+     *         shape when a fixture is made from it.
+     */
+    struct ShapePrefab
+    {
+        /*
+         *  \var shape
+         *  \brief The Box2D shape in meters.
+         */
+        std::shared_ptr<const b2Shape> shape;
+
+        /*
+         *  \var density
+         *  \brief The density of the shape.
+         */
+        float density;
+
+        /*
+         *  \var friction
+         *  \brief The friction of the shape.
+         */
+        float friction;
+    };
+
+    /*
+     *  \class PhysicsPrefab
+     *  \brief The body type and shapes used by every instance.
+     */
+    struct PhysicsPrefab
+    {
+        /*
+         *  \var type
+         *  \brief The type of body.
+         */
+        PhysicsBody::Type type;
+
+        /*
+         *  \var shapes
+         *  \brief The collision shapes of the body.
+         */
+        std::vector<ShapePrefab> shapes;
+    };
+
+    /*
+     *  \class ChildPrefab
+     *  \brief An actor created and attached with every instance.
+     */
+    struct ChildPrefab
+    {
+        /*
+         *  \var filename
+         *  \brief The name of the child's actor file without an extension.
+         */
+        std::string filename;
+
+        /*
+         *  \var offset
+         *  \brief The position relative to the parent in pixels.
+         */
+        Vector2 offset;
+
+        /*
+         *  \var rotation
+         *  \brief The rotation relative to the parent in degrees.
+         */
+        double rotation;
+    };
+
+    /*
+     *  \var sprite
+     *  \brief An optional sprite.
+     */
+    std::unique_ptr<const SpritePrefab> sprite;
+
+    /*
+     *  \var script
+     *  \brief An optional script.
+     */
+    std::unique_ptr<const ScriptPrefab> script;
+
+    /*
+     *  \var physics
+     *  \brief An optional physics body.
+     */
+    std::unique_ptr<const PhysicsPrefab> physics;
+
+    /*
+     *  \var children
+     *  \brief Actors attached to every instance.
+     */
+    std::vector<ChildPrefab> children;
+
+    /*
+     *  \var tags
+     *  \brief The bits of the tags every instance is given.
+     */
+    ComponentMask tags;
+};
+}
+
+#endif
@@ -0,0 +1,96 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#ifndef NYRA_PREFAB_CACHE_H_
+#define NYRA_PREFAB_CACHE_H_
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <nyra/Prefab.h>
+#include <nyra/Graphics.h>
+#include <nyra/ComponentStore.h>
+
+namespace nyra
+{
+/*
+ *  \class PrefabCache
+ *  \brief Parses each actor file once and hands out the same Prefab to
+ *         every instance of it.
+ */
+class PrefabCache
+{
+public:
+    /*
+     *  \func Constructor
+     *  \brief Creates an empty cache.
+     *
+     *  \param dataDir The data directory that holds the actor files.
+     *  \param graphics Used to look up the textures of sprites.
+     *  \param components Used to look up the bits of tags.
+     */
+    PrefabCache(const std::string& dataDir,
+                Graphics& graphics,
+                ComponentStore& components);
+
+    /*
+     *  \func get
+     *  \brief Gets a prefab, parsing its actor file the first time.
+     *
+     *  \param filename The name of the actor file without an extension.
+     *  \return The prefab.
+     *  \throw If the actor file cannot be parsed, is invalid or lists
+     *         itself as a child directly or indirectly.
+     */
+    const Prefab& get(const std::string& filename);
+
+    /*
+     *  \func clear
+     *  \brief Releases every prefab and the textures they hold.
+     */
+    void clear();
+
+    /*
+     *  \func getSize
+     *  \brief Gets the number of prefabs that have been parsed.
+     *
+     *  \return The number of prefabs.
+     */
+    inline size_t getSize() const
+    {
+        return mPrefabs.size();
+    }
+
+private:
+    std::unique_ptr<const Prefab> load(const std::string& filename);
+
+    const std::string mDataDir;
+    Graphics& mGraphics;
+    ComponentStore& mComponents;
+    std::unordered_map<std::string, std::unique_ptr<const Prefab> > mPrefabs;
+    std::vector<std::string> mLoading;
+};
+}
+
+#endif
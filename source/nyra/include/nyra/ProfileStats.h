@@ -0,0 +1,84 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#ifndef NYRA_PROFILE_STATS_H_
+#define NYRA_PROFILE_STATS_H_
+
+#include <stddef.h>
+
+namespace nyra
+{
+/*
+ *  \class ProfileStats
+ *  \brief Timing statistics for a single profiled phase. All times are in
+ *         milliseconds. This is kept separate from the Profiler so it can
+ *         be passed through to Python.
+ */
+struct ProfileStats
+{
+    /*
+     *  \func Constructor
+     *  \brief Creates an empty set of stats.
+     */
+    ProfileStats() :
+        count(0),
+        minimum(0.0),
+        average(0.0),
+        maximum(0.0),
+        p99(0.0)
+    {
+    }
+
+    /*
+     *  \var count
+     *  \brief The number of samples the stats were built from.
+     */
+    size_t count;
+
+    /*
+     *  \var minimum
+     *  \brief The shortest sample.
+     */
+    double minimum;
+
+    /*
+     *  \var average
+     *  \brief The mean of all samples.
+     */
+    double average;
+
+    /*
+     *  \var maximum
+     *  \brief The longest sample.
+     */
+    double maximum;
+
+    /*
+     *  \var p99
+     *  \brief The 99th percentile sample.
+     */
+    double p99;
+};
+}
+
+#endif
@@ -0,0 +1,216 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#ifndef NYRA_PROFILER_H_
+#define NYRA_PROFILER_H_
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <stdint.h>
+#include <nyra/ProfileStats.h>
+
+#define NYRA_PROFILE_CONCAT_IMPL(a, b) a##b
+#define NYRA_PROFILE_CONCAT(a, b) NYRA_PROFILE_CONCAT_IMPL(a, b)
+
+/*
+ *  \def NYRA_PROFILE
+ *  \brief Times the rest of the enclosing scope and records it under
+ *         phase. The phase must be a string literal. Defining
+ *         NYRA_DISABLE_PROFILER compiles this out completely.
+ */
+#ifdef NYRA_DISABLE_PROFILER
+#define NYRA_PROFILE(phase)
+#else
+#define NYRA_PROFILE(phase) \
+        const nyra::ScopedProfile NYRA_PROFILE_CONCAT(nyraProfile, __LINE__)(phase)
+#endif
+
+namespace nyra
+{
+/*
+ *  \class Profiler
+ *  \brief Collects timed samples from any thread. Each thread records into
+ *         its own fixed size ring buffer so only the most recent samples
+ *         are kept. The engine owns its profiler and registers it so the
+ *         NYRA_PROFILE macro records into it.
+ */
+class Profiler
+{
+public:
+    /*
+     *  \func Constructor
+     *  \brief Creates an empty profiler. The time it is created is used as
+     *         the start of any trace.
+     */
+    Profiler();
+
+    /*
+     *  \func Destructor
+     *  \brief Releases all of the thread buffers.
+     */
+    ~Profiler();
+
+    /*
+     *  \func registerProfiler
+     *  \brief Sets the profiler the NYRA_PROFILE macro records into. The
+     *         profiler must stay alive until it is unregistered.
+     *
+     *  \param profiler The profiler to register, or nullptr to go back to
+     *         a fallback that nothing reads.
+     */
+    static void registerProfiler(Profiler* profiler);
+
+    /*
+     *  \func getRegisteredProfiler
+     *  \brief Gets the registered profiler. The NYRA_PROFILE macro always
+     *         records here. Each binary that links the library has its own
+     *         registration, so code outside of the engine binary should
+     *         reach the profiler through the Engine instead.
+     *
+     *  \return The registered profiler.
+     */
+    static Profiler& getRegisteredProfiler();
+
+    /*
+     *  \func now
+     *  \brief Gets a monotonic timestamp.
+     *
+     *  \return The current time in microseconds.
+     */
+    static int64_t now();
+
+    /*
+     *  \func record
+     *  \brief Records a sample on the calling thread. In general use the
+     *         NYRA_PROFILE macro instead.
+     *
+     *  \param phase The name of the phase. This must outlive the profiler.
+     *  \param start The timestamp the phase started at.
+     *  \param end The timestamp the phase ended at.
+     */
+    void record(const char* phase,
+                int64_t start,
+                int64_t end);
+
+    /*
+     *  \func getStats
+     *  \brief Builds stats for a phase from the samples still held by all
+     *         threads.
+     *
+     *  \param phase The name of the phase.
+     *  \return The stats. If there are no samples the count will be 0.
+     */
+    ProfileStats getStats(const std::string& phase) const;
+
+    /*
+     *  \func getPhases
+     *  \brief Gets the name of every phase that has samples.
+     *
+     *  \return The phase names sorted alphabetically.
+     */
+    std::vector<std::string> getPhases() const;
+
+    /*
+     *  \func dumpTrace
+     *  \brief Writes all held samples as a Chrome trace_event JSON file. It
+     *         can be opened with chrome://tracing.
+     *
+     *  \param pathname The pathname of the file to write.
+     *  \throw If the file cannot be opened.
+     */
+    void dumpTrace(const std::string& pathname) const;
+
+    /*
+     *  \func clear
+     *  \brief Throws away all held samples.
+     */
+    void clear();
+
+private:
+    struct Event
+    {
+        const char* phase;
+        int64_t start;
+        int64_t duration;
+    };
+
+    struct ThreadBuffer
+    {
+        ThreadBuffer(size_t threadId);
+
+        std::mutex mutex;
+        const size_t threadId;
+        std::vector<Event> events;
+        size_t next;
+    };
+
+    ThreadBuffer& getThreadBuffer();
+
+    const uint64_t mId;
+    const int64_t mEpoch;
+    mutable std::mutex mMutex;
+    std::vector<std::unique_ptr<ThreadBuffer> > mBuffers;
+    std::unordered_map<std::thread::id, ThreadBuffer*> mThreadBuffers;
+};
+
+/*
+ *  \class ScopedProfile
+ *  \brief Records the lifetime of the object as a sample in the
+ *         registered Profiler. Use the NYRA_PROFILE macro to create these.
+ */
+class ScopedProfile
+{
+public:
+    /*
+     *  \func Constructor
+     *  \brief Starts timing.
+     *
+     *  \param phase The name of the phase. This must be a string literal.
+     */
+    ScopedProfile(const char* phase) :
+        mPhase(phase),
+        mStart(Profiler::now())
+    {
+    }
+
+    /*
+     *  \func Destructor
+     *  \brief Stops timing and records the sample.
+     */
+    ~ScopedProfile()
+    {
+        Profiler::getRegisteredProfiler().record(
+                mPhase, mStart, Profiler::now());
+    }
+
+private:
+    const char* const mPhase;
+    const int64_t mStart;
+};
+}
+
+#endif
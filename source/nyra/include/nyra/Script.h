@@ -48,13 +48,50 @@ public:
     *  \param className The Python class. If this does not have a class
     *         pass in an empty string. All methods will be assinged based
     *         on the module instead.
-    *  \param data Because the Python layer is loaded through a shared
-    *         object we need to pass in the data pointer so it has access
-    *         to the memory.
+    *  \param data The value passed to the script's set_data method. Because
+    *         the Python layer is loaded through a shared object this is
+    *         how it finds the memory it belongs to.
     */
     Script(const std::string& moduleName,
            const std::string& className,
-           void* data);
+           size_t data);
+
+   /*
+    *  \func Constructor
+    *  \brief Creates the Python script object from a module and class that
+    *         were already looked up. This is much cheaper when many
+    *         scripts share a class.
+    *
+    *  \param module The Python module.
+    *  \param classObject The Python class or null to assign all methods
+    *         based on the module.
+    *  \param data The value passed to the script's set_data method.
+    */
+    Script(const AutoPy& module,
+           const AutoPy& classObject,
+           size_t data);
+
+    /*
+     *  \func importModule
+     *  \brief Imports a Python module.
+     *
+     *  \param moduleName The name of the module.
+     *  \return The module.
+     *  \throw If the module cannot be imported.
+     */
+    static AutoPy importModule(const std::string& moduleName);
+
+    /*
+     *  \func getClass
+     *  \brief Looks up a class in a Python module.
+     *
+     *  \param module The module that holds the class.
+     *  \param className The name of the class.
+     *  \return The class.
+     *  \throw If the class does not exist.
+     */
+    static AutoPy getClass(const AutoPy& module,
+                           const std::string& className);
 
     /*
      *  \func addMethod
@@ -102,12 +139,46 @@ public:
         callMethod(methodKey, getArgList<T>(param));
     }
 
-private:
+    /*
+     *  \func hasMethod
+     *  \brief Checks if a method has been registered.
+     *
+     *  \param methodKey The C++ key associated with the method.
+     *  \return True if the method can be called.
+     */
     inline bool hasMethod(const std::string& methodKey) const
     {
         return mMethods.find(methodKey) != mMethods.end();
     }
 
+    /*
+     *  \func getIndex
+     *  \brief Gets the position of this object in its owner's list. This
+     *         should only be used internally.
+     *
+     *  \return The index.
+     */
+    inline size_t getIndex() const
+    {
+        return mIndex;
+    }
+
+    /*
+     *  \func setIndex
+     *  \brief Records the position of this object in its owner's list so
+     *         it can be removed without a search. This should only be
+     *         called internally.
+     *
+     *  \param index The index.
+     */
+    inline void setIndex(size_t index)
+    {
+        mIndex = index;
+    }
+
+private:
+    void createInstance(size_t data);
+
     void callMethod(const std::string& method,
                     const AutoPy& argList);
 
@@ -136,7 +207,19 @@ private:
     AutoPy mClass;
     AutoPy mInstance;
     std::unordered_map<std::string, AutoPy> mMethods;
+    size_t mIndex;
 };
+
+// Parameter types that can be passed to Python. These are defined in
+// Script.cpp.
+template <>
+void Script::addParam(const AutoPy& argList, size_t pos, double value);
+
+template <>
+void Script::addParam(const AutoPy& argList, size_t pos, size_t value);
+
+template <>
+void Script::addParam(const AutoPy& argList, size_t pos, PyObject* value);
 }
 
 #endif
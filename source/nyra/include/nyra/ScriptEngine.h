@@ -25,9 +25,12 @@
 #define NYRA_SCRIPT_ENGINE_H_
 
 #include <nyra/Script.h>
+#include <nyra/Arena.h>
 #include <vector>
 #include <string>
 #include <memory>
+#include <unordered_map>
+#include <utility>
 
 namespace nyra
 {
@@ -46,8 +49,9 @@ public:
      *
      *  \param engine Python needs access to the engine pointer because it
      *         is in a different memory space than the rest of the engine.
+     *  \param arena The map arena that scripts are allocated from.
      */
-    ScriptEngine(void* engine);
+    ScriptEngine(void* engine, Arena& arena);
 
     /*
      *  \func Destructor
@@ -63,14 +67,14 @@ public:
 
     /*
      *  \func update
-     *  \brief Calls update on all the scripts.
+     *  \brief Calls update on all the active scripts.
      *
      *  \param deltaTime The time since the last call to update.
      */
     void update(double deltaTime);
     /*
      *  \func init
-     *  \brief Calls the init method on all scripts
+     *  \brief Calls the init method on all active scripts
      */
     void init();
 
@@ -81,16 +85,57 @@ public:
      *  \param moduleName The name of the module
      *  \param className The name of the class. If this is a module only
      *         script, you can pass in an empty string here.
-     *  \param data Any script defined data. For actors this should point
-     *         to the underlying C++ Actor object.
+     *  \param data Any script defined data. For actors this should be
+     *         the handle of the Actor.
      */
     Script* addScript(const std::string& moduleName,
                       const std::string& className,
-                      void* data);
+                      size_t data);
+
+    /*
+     *  \func reserve
+     *  \brief Makes room for more scripts so adding them does not grow the
+     *         list one at a time.
+     *
+     *  \param count The number of scripts about to be added.
+     */
+    inline void reserve(size_t count)
+    {
+        mScripts.reserve(mScripts.size() + count);
+    }
+
+    /*
+     *  \func removeScript
+     *  \brief Destroys a managed script. This must not be called while
+     *         scripts are being updated.
+     *
+     *  \param script The script to destroy. It is no longer valid after
+     *         this.
+     */
+    void removeScript(Script& script);
+
+    /*
+     *  \func setActive
+     *  \brief Sets whether a script is updated. Scripts start active.
+     *         Active scripts are kept at the front of the list so update
+     *         never visits inactive ones. This is safe to call while
+     *         scripts are being updated.
+     *
+     *  \param script The script to change.
+     *  \param active True if the script should be updated.
+     */
+    void setActive(Script& script, bool active);
 
 private:
+    void swapScripts(size_t first, size_t second);
+
     std::unique_ptr<Script> mEngineScript;
-    std::vector<std::unique_ptr<Script> > mScripts;
+    ArenaPool<Script> mScriptPool;
+    std::vector<Script*> mScripts;
+    size_t mActiveScripts;
+
+    // Modules and classes already looked up, keyed by module and class
+    std::unordered_map<std::string, std::pair<AutoPy, AutoPy> > mClasses;
 };
 }
 
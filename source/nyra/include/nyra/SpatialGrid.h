@@ -0,0 +1,113 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#ifndef NYRA_SPATIAL_GRID_H_
+#define NYRA_SPATIAL_GRID_H_
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <SFML/Graphics.hpp>
+
+namespace nyra
+{
+/*
+ *  \class SpatialGrid
+ *  \brief A uniform grid of rectangles used to quickly find which objects
+ *         overlap an area. Objects are identified by a small integer id
+ *         and are only moved between cells when their cell range changes.
+ */
+class SpatialGrid
+{
+public:
+    /*
+     *  \func Constructor
+     *  \brief Creates an empty grid.
+     *
+     *  \param cellSize The width and height of each cell in pixels.
+     */
+    SpatialGrid(float cellSize);
+
+    /*
+     *  \func update
+     *  \brief Inserts an object or moves it to new bounds.
+     *
+     *  \param id The id of the object. Ids should be densely packed.
+     *  \param bounds The axis aligned bounds of the object.
+     */
+    void update(size_t id, const sf::FloatRect& bounds);
+
+    /*
+     *  \func remove
+     *  \brief Removes an object from the grid. Nothing happens if the
+     *         object is not in the grid.
+     *
+     *  \param id The id of the object.
+     */
+    void remove(size_t id);
+
+    /*
+     *  \func clear
+     *  \brief Removes every object from the grid.
+     */
+    void clear();
+
+    /*
+     *  \func query
+     *  \brief Finds every object that overlaps an area. Each object is
+     *         reported once and in no particular order.
+     *
+     *  \param area The area to search.
+     *  \param results The ids of the overlapping objects are appended here.
+     */
+    void query(const sf::FloatRect& area,
+               std::vector<size_t>& results);
+
+private:
+    struct Entry
+    {
+        bool inserted;
+        int left;
+        int top;
+        int right;
+        int bottom;
+        sf::FloatRect bounds;
+        size_t query;
+    };
+
+    int toCell(float value) const;
+
+    static uint64_t getKey(int x, int y);
+
+    void addToCells(size_t id, const Entry& entry);
+
+    void removeFromCells(size_t id, const Entry& entry);
+
+    const float mCellSize;
+    std::unordered_map<uint64_t, std::vector<size_t> > mCells;
+    std::vector<Entry> mEntries;
+    size_t mQuery;
+};
+}
+
+#endif
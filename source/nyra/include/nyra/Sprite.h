@@ -25,7 +25,9 @@
 #define NYRA_SPRITE_H_
 
 #include <memory>
+#include <vector>
 #include <SFML/Graphics.hpp>
+#include <nyra/TextureManager.h>
 
 namespace nyra
 {
@@ -41,9 +43,9 @@ public:
      *  \func Constructor
      *  \brief Creates an SFML sprite under the hood.
      *
-     *  \param pathname The location of the texture on disk.
+     *  \param region The shared texture and the area of it to draw.
      */
-    Sprite(const std::string& pathname);
+    Sprite(const TextureRegion& region);
 
     /*
      *  \func get
@@ -58,18 +60,131 @@ public:
 
     /*
      *  \func get
-     *  \brief Get the underlying SFML sprite.
+     *  \brief Get the underlying SFML sprite. Since the sprite may be
+     *         changed through this it is always flagged as dirty.
      *
      *  \return The SFML sprite.
      */
     inline sf::Sprite& get()
     {
+        markDirty();
         return mSprite;
     }
 
+    /*
+     *  \func setPosition
+     *  \brief Sets the position of the sprite.
+     *
+     *  \param position The position in pixels.
+     */
+    inline void setPosition(const sf::Vector2f& position)
+    {
+        mSprite.setPosition(position);
+        markDirty();
+    }
+
+    /*
+     *  \func setRotation
+     *  \brief Sets the rotation of the sprite.
+     *
+     *  \param rotation The rotation in degrees.
+     */
+    inline void setRotation(float rotation)
+    {
+        mSprite.setRotation(rotation);
+        markDirty();
+    }
+
+    /*
+     *  \func setOrigin
+     *  \brief Sets the point the sprite is positioned and rotated around.
+     *
+     *  \param origin The origin in pixels from the top left of the sprite.
+     */
+    inline void setOrigin(const sf::Vector2f& origin)
+    {
+        mSprite.setOrigin(origin);
+        markDirty();
+    }
+
+    /*
+     *  \func setVisible
+     *  \brief Sets whether the sprite is drawn.
+     *
+     *  \param visible True if the sprite should be drawn.
+     */
+    inline void setVisible(bool visible)
+    {
+        mVisible = visible;
+        markDirty();
+    }
+
+    /*
+     *  \func isVisible
+     *  \brief Checks if the sprite is drawn.
+     *
+     *  \return True if the sprite is drawn.
+     */
+    inline bool isVisible() const
+    {
+        return mVisible;
+    }
+
+    /*
+     *  \func isDirty
+     *  \brief Checks if the sprite has changed since it was last drawn.
+     *
+     *  \return True if the sprite has changed.
+     */
+    inline bool isDirty() const
+    {
+        return mDirty;
+    }
+
+    /*
+     *  \func setClean
+     *  \brief Marks that the renderer has picked up the latest changes.
+     *         This should only be called internally.
+     */
+    inline void setClean()
+    {
+        mDirty = false;
+    }
+
+    /*
+     *  \func setDirtyList
+     *  \brief Sets a list the sprite adds itself to each time it goes
+     *         from clean to dirty. This lets the renderer visit only the
+     *         sprites that changed. This should only be called internally.
+     *
+     *  \param list The list to add to or nullptr to stop tracking.
+     *  \param index The value added to the list for this sprite.
+     */
+    inline void setDirtyList(std::vector<size_t>* list, size_t index)
+    {
+        mDirtyList = list;
+        mIndex = index;
+    }
+
 private:
+    inline void markDirty()
+    {
+        if (!mDirty)
+        {
+            mDirty = true;
+            if (mDirtyList)
+            {
+                mDirtyList->push_back(mIndex);
+            }
+        }
+    }
+
     sf::Sprite mSprite;
-    std::shared_ptr<sf::Texture> mTexture;
+    bool mDirty;
+    bool mVisible;
+    std::vector<size_t>* mDirtyList;
+    size_t mIndex;
+    std::shared_ptr<const sf::Texture> mTexture;
 };
 }
 
@@ -25,7 +25,7 @@
 #define NYRA_SWIG_ACTOR_H_
 
 #include <stddef.h>
-#include <nyra/Actor.h>
+#include <nyra/ActorHandle.h>
 #include <nyra/Vector2.h>
 
 namespace nyra
@@ -40,7 +40,8 @@ class SwigActor
 public:
     /*
      *  \func Constructor
-     *  \brief Nulls out the Actor data.
+     *  \brief Starts without an Actor. Every call fails until the data
+     *         is set.
      */
     SwigActor();
 
@@ -80,24 +81,56 @@ public:
      */
     void _apply_force(const Vector2& vector) const;
 
+    /*
+     *  \func _attach
+     *  \brief Attaches the actor to a parent. Use attach from Python.
+     *
+     *  \param parent The actor to follow.
+     *  \param offset The position relative to the parent in pixels.
+     *  \param rotation The rotation relative to the parent in degrees.
+     */
+    void _attach(const SwigActor& parent,
+                 const Vector2& offset,
+                 double rotation) const;
+
+    /*
+     *  \func detach
+     *  \brief Detaches the actor from its parent.
+     */
+    void detach() const;
+
+    /*
+     *  \func destroy
+     *  \brief Destroys the Actor at the end of the frame. The Actor can
+     *         not be used after that.
+     */
+    void destroy() const;
+
+    /*
+     *  \func despawn
+     *  \brief Returns the Actor to its pool at the end of the frame. An
+     *         Actor that was not spawned is destroyed instead.
+     */
+    void despawn() const;
+
     /*
      *  \func _set_data
      *  \brief Sets the Actor data. This should be used internally only.
      *
-     *  \param address The memory address of the Actor.
+     *  \param handle The handle of the Actor.
      */
-    void _set_data(size_t address);
+    void _set_data(size_t handle);
 
     /*
      *  \func _get_data
-     *  \brief Gets the data pointer. This should be used internally only.
+     *  \brief Gets the Actor data. This should be used internally only.
      *
-     *  \return The memory address of the Actor.
+     *  \return The handle of the Actor.
      */
     size_t _get_data() const;
 
 private:
-    Actor* mData;
+    ActorHandle mData;
 };
 }
 
@@ -27,9 +27,27 @@
 #include <string>
 #include <vector>
 #include <nyra/Vector2.h>
+#include <nyra/ProfileStats.h>
+#include <nyra/PhysicsSettings.h>
+#include <nyra/PhysicsStats.h>
+#include <nyra/PhysicsHits.h>
 
 namespace nyra
 {
+#ifndef SWIG
+class Engine;
+
+/*
+ *  \func _get_engine
+ *  \brief Gets the engine set by _set_data. This is used by the other
+ *         Python wrappers and is not exposed to Python.
+ *
+ *  \return The engine.
+ *  \throw If the engine has not been set.
+ */
+Engine& _get_engine();
+#endif
+
 /*
  *  \func _register_input
  *  \brief Allows input to be registered from Python.
@@ -111,12 +129,218 @@ void log(const std::string& message);
  *  \func _camera_track
  *  \brief Sets the camera to track an actor.
  *
- *  \param actor The memory address of the actor to track.
+ *  \param actor The handle of the actor to track.
  *  \param offset The tracking offset in pixels.
  */
 void _camera_track(size_t actor,
                    const Vector2& offset);
 
+/*
+ *  \func _spawn
+ *  \brief Spawns an actor from its pool.
+ *
+ *  \param filename The name of the actor file without an extension.
+ *  \param position The position to place the actor at.
+ *  \return The handle of the spawned actor.
+ */
+size_t _spawn(const std::string& filename,
+              const Vector2& position);
+
+/*
+ *  \func prewarm
+ *  \brief Adds inactive actors to a pool so spawning them is cheap.
+ *
+ *  \param filename The name of the actor file without an extension.
+ *  \param count The number of actors to add.
+ */
+void prewarm(const std::string& filename,
+             size_t count);
+
+/*
+ *  \func _spawn_many
+ *  \brief Adds many instances of an actor file at once and initializes
+ *         their scripts. This is cheaper than adding them one at a time.
+ *
+ *  \param filename The name of the actor file without an extension.
+ *  \param coordinates The x and y of each position in pixels, flattened.
+ *  \param rotations The rotation of each actor in degrees, or empty to
+ *         leave them unrotated.
+ *  \return The handles of the new actors in the order of the positions.
+ *  \throw If the rotations do not match the positions.
+ */
+std::vector<size_t> _spawn_many(const std::string& filename,
+                                const std::vector<double>& coordinates,
+                                const std::vector<double>& rotations);
+
+/*
+ *  \func _add_query
+ *  \brief Gets a cached query for every active actor with the given
+ *         components and tags.
+ *
+ *  \param components The names of required components ("sprite",
+ *         "physics" or "script").
+ *  \param tags The names of required tags.
+ *  \return The index of the query.
+ *  \throw If a component name is invalid.
+ */
+size_t _add_query(const std::vector<std::string>& components,
+                  const std::vector<std::string>& tags);
+
+/*
+ *  \func _query_results
+ *  \brief Gets the actors that currently match a query.
+ *
+ *  \param query The index of the query.
+ *  \return The handles of the matching actors.
+ *  \throw If the query does not exist.
+ */
+std::vector<size_t> _query_results(size_t query);
+
+/*
+ *  \func _query_size
+ *  \brief Gets the number of actors that currently match a query without
+ *         copying the results.
+ *
+ *  \param query The index of the query.
+ *  \return The number of matching actors.
+ *  \throw If the query does not exist.
+ */
+size_t _query_size(size_t query);
+
+/*
+ *  \func _post_event
+ *  \brief Queues an event for one actor. It is handed to the events
+ *         method of the actor's script when the events phase runs.
+ *
+ *  \param name The type of the event.
+ *  \param target The handle of the actor that receives the event.
+ *  \param source The handle of the actor that sent the event.
+ *  \param value A value that is passed along with the event.
+ *  \param position A position that is passed along with the event.
+ */
+void _post_event(const std::string& name,
+                 size_t target,
+                 size_t source,
+                 double value,
+                 const Vector2& position);
+
+/*
+ *  \func _broadcast_event
+ *  \brief Queues an event for every actor that currently matches a query.
+ *
+ *  \param name The type of the event.
+ *  \param query The index of the query whose actors receive the event.
+ *  \param source The handle of the actor that sent the event.
+ *  \param value A value that is passed along with the event.
+ *  \param position A position that is passed along with the event.
+ *  \throw If the query does not exist.
+ */
+void _broadcast_event(const std::string& name,
+                      size_t query,
+                      size_t source,
+                      double value,
+                      const Vector2& position);
+
+/*
+ *  \func _profile_stats
+ *  \brief Gets the timing stats of a profiled engine phase.
+ *
+ *  \param phase The name of the phase (e.g. "physics")
+ *  \return The stats in milliseconds.
+ */
+ProfileStats _profile_stats(const std::string& phase);
+
+/*
+ *  \func _profile_phases
+ *  \brief Gets the names of all phases that have been profiled.
+ *
+ *  \return The phase names.
+ */
+std::vector<std::string> _profile_phases();
+
+/*
+ *  \func dump_profile
+ *  \brief Writes the profiled phases to a Chrome trace file.
+ *
+ *  \param pathname The pathname of the JSON file to write.
+ */
+void dump_profile(const std::string& pathname);
+
+/*
+ *  \func arena_high_water_mark
+ *  \brief Gets the most bytes the map arena has had in use at once since
+ *         the current map was loaded.
+ *
+ *  \return The number of bytes.
+ */
+size_t arena_high_water_mark();
+
+/*
+ *  \func get_physics_settings
+ *  \brief Gets how the physics world is solved.
+ *
+ *  \return The current settings.
+ */
+PhysicsSettings get_physics_settings();
+
+/*
+ *  \func set_physics_settings
+ *  \brief Changes how the physics world is solved. This takes effect on
+ *         the next step.
+ *
+ *  \param settings The new settings.
+ *  \throw If there are no sub steps.
+ */
+void set_physics_settings(const PhysicsSettings& settings);
+
+/*
+ *  \func physics_stats
+ *  \brief Gets what the last physics update cost and how busy the world
+ *         is.
+ *
+ *  \return The stats of the last update.
+ */
+PhysicsStats physics_stats();
+
+/*
+ *  \func _ray_cast_many
+ *  \brief Casts many rays at once and finds the closest body each one
+ *         passes through. Sensors are ignored.
+ *
+ *  \param coordinates The x and y of the start and end of each ray in
+ *         pixels, flattened.
+ *  \return One hit for each ray.
+ *  \throw If the coordinates do not describe whole rays.
+ */
+PhysicsHits _ray_cast_many(const std::vector<double>& coordinates);
+
+/*
+ *  \func _circle_cast_many
+ *  \brief Moves many circles along paths at once and finds the first body
+ *         each one touches. Sensors are ignored.
+ *
+ *  \param coordinates The x and y of the start and end of each path in
+ *         pixels, flattened.
+ *  \param radii The radius of each circle in pixels.
+ *  \return One hit for each circle.
+ *  \throw If the coordinates do not describe whole paths or there is not
+ *         a radius for every path.
+ */
+PhysicsHits _circle_cast_many(const std::vector<double>& coordinates,
+                              const std::vector<double>& radii);
+
+/*
+ *  \func _query_box_many
+ *  \brief Finds the actors with a body that overlaps each of many boxes.
+ *         Sensors and bodies without an actor are ignored.
+ *
+ *  \param coordinates The x and y of the top left and bottom right of
+ *         each box in pixels, flattened.
+ *  \return The actors found by every box.
+ *  \throw If the coordinates do not describe whole boxes.
+ */
+PhysicsOverlaps _query_box_many(const std::vector<double>& coordinates);
+
 /*
  *  \func _set_data
  *  \brief Sets the engine instance to allow Python to use the same
@@ -0,0 +1,166 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#ifndef NYRA_TEXTURE_MANAGER_H_
+#define NYRA_TEXTURE_MANAGER_H_
+
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <SFML/Graphics.hpp>
+
+namespace nyra
+{
+/*
+ *  \class TextureRegion
+ *  \brief A shared texture and the part of it an image occupies. Holding
+ *         one of these keeps the texture alive.
+ */
+struct TextureRegion
+{
+    /*
+     *  \var texture
+     *  \brief The shared texture. In headless mode this is never uploaded.
+     */
+    std::shared_ptr<const sf::Texture> texture;
+
+    /*
+     *  \var rect
+     *  \brief The area of the texture in pixels.
+     */
+    sf::IntRect rect;
+};
+
+/*
+ *  \class TextureManager
+ *  \brief Loads each texture once and shares it between every sprite that
+ *         uses it. Textures are looked up by their canonical path so
+ *         different spellings of the same file still share. Images that
+ *         have been packed into an atlas resolve to a region of the page
+ *         they were packed into instead of their own texture.
+ */
+class TextureManager
+{
+public:
+    /*
+     *  \func Constructor
+     *  \brief Creates an empty manager.
+     *
+     *  \param loadTextures If false images are only read to find their
+     *         size and nothing is uploaded. This is used when running
+     *         without a graphics device.
+     */
+    TextureManager(bool loadTextures);
+
+    /*
+     *  \func get
+     *  \brief Gets a texture, loading it if it is not already held.
+     *
+     *  \param pathname The pathname to the image on disk.
+     *  \return The texture and the area of the image within it.
+     *  \throw If the image cannot be loaded.
+     */
+    TextureRegion get(const std::string& pathname);
+
+    /*
+     *  \func loadAtlas
+     *  \brief Loads every page of an atlas. After this any request for an
+     *         image packed into the atlas returns the page it lives on.
+     *         Atlas pages are held until the manager is destroyed.
+     *
+     *  \param pathname The pathname to the atlas json file.
+     *  \throw If the atlas or any of its pages cannot be loaded.
+     */
+    void loadAtlas(const std::string& pathname);
+
+    /*
+     *  \func purge
+     *  \brief Releases every texture that is no longer used outside of
+     *         the manager.
+     */
+    void purge();
+
+    /*
+     *  \func getHits
+     *  \brief Gets how many requests were served from the cache.
+     *
+     *  \return The number of cache hits.
+     */
+    inline size_t getHits() const
+    {
+        return mHits;
+    }
+
+    /*
+     *  \func getMisses
+     *  \brief Gets how many requests had to load from disk.
+     *
+     *  \return The number of cache misses.
+     */
+    inline size_t getMisses() const
+    {
+        return mMisses;
+    }
+
+    /*
+     *  \func getTextureCount
+     *  \brief Gets the number of textures currently held.
+     *
+     *  \return The number of textures.
+     */
+    inline size_t getTextureCount() const
+    {
+        return mTextures.size();
+    }
+
+    /*
+     *  \func getMemoryUsage
+     *  \brief Gets the estimated memory used by held textures assuming
+     *         four bytes per pixel.
+     *
+     *  \return The memory used in bytes.
+     */
+    inline size_t getMemoryUsage() const
+    {
+        return mMemoryUsage;
+    }
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<const sf::Texture> texture;
+        sf::Vector2u size;
+    };
+
+    const Entry& load(const std::string& key);
+
+    const bool mLoadTextures;
+    std::unordered_map<std::string, Entry> mTextures;
+    std::unordered_map<std::string, TextureRegion> mAtlas;
+    size_t mHits;
+    size_t mMisses;
+    size_t mMemoryUsage;
+};
+}
+
+#endif
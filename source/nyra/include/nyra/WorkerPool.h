@@ -0,0 +1,102 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#ifndef NYRA_WORKER_POOL_H_
+#define NYRA_WORKER_POOL_H_
+
+#include <vector>
+#include <functional>
+#include <exception>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace nyra
+{
+/*
+ *  \class WorkerPool
+ *  \brief A fixed set of threads that run the parts of a job at the same
+ *         time. The thread that starts a job also works on it and waits
+ *         for every part to finish, so a job looks like a plain loop to
+ *         the caller. This is meant for a few large parts, such as
+ *         stepping physics sectors, rather than many small ones.
+ */
+class WorkerPool
+{
+public:
+    /*
+     *  \func Constructor
+     *  \brief Starts the worker threads.
+     *
+     *  \param threads The number of threads to start in addition to the
+     *         calling thread. With zero every job runs on the caller.
+     */
+    WorkerPool(size_t threads);
+
+    /*
+     *  \func Destructor
+     *  \brief Stops and joins the worker threads.
+     */
+    ~WorkerPool();
+
+    /*
+     *  \func run
+     *  \brief Calls a task once for each part of a job and returns when
+     *         every call has finished. Calls may happen on any thread in
+     *         any order. This must not be called from inside a task.
+     *
+     *  \param count The number of parts.
+     *  \param task The task to call with the index of each part.
+     *  \throw The first exception thrown by a task. It is rethrown on the
+     *         calling thread once every part has finished.
+     */
+    void run(size_t count, const std::function<void(size_t)>& task);
+
+    /*
+     *  \func getThreadCount
+     *  \brief Gets the number of worker threads.
+     *
+     *  \return The number of threads not counting the caller.
+     */
+    inline size_t getThreadCount() const
+    {
+        return mThreads.size();
+    }
+
+private:
+    void workLoop();
+
+    std::vector<std::thread> mThreads;
+    std::mutex mMutex;
+    std::condition_variable mStart;
+    std::condition_variable mDone;
+    const std::function<void(size_t)>* mTask;
+    size_t mCount;
+    size_t mNext;
+    size_t mRemaining;
+    std::exception_ptr mError;
+    bool mStopping;
+};
+}
+
+#endif
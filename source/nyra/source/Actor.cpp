@@ -23,29 +23,39 @@
  */
 #include <nyra/Actor.h>
 #include <nyra/Logger.h>
+#include <stdexcept>
 
 namespace nyra
 {
 //===========================================================================//
 Actor::Actor() :
-    mSprite(nullptr),
-    mScript(nullptr),
-    mPhysics(nullptr)
+    mStore(nullptr),
+    mHandle(INVALID_ACTOR)
+{
+}
+
+//===========================================================================//
+Actor::Actor(ComponentStore& store, ActorHandle handle) :
+    mStore(&store),
+    mHandle(handle)
 {
 }
 
 //===========================================================================//
 void Actor::setPosition(const Vector2& position) const
 {
+    const size_t id = getId();
     bool foundComponent = false;
-    if (mSprite)
+    mStore->getTransform(id).position = position;
+    if (mStore->hasSprite(id))
     {
-        mSprite->get().setPosition(position.toThirdParty<sf::Vector2f>());
+        mStore->getSprite(id).setPosition(
+                position.toThirdParty<sf::Vector2f>());
         foundComponent = true;
     }
-    if (mPhysics)
+    if (mStore->hasPhysics(id))
     {
-        mPhysics->setPosition(position);
+        mStore->getPhysics(id).setPosition(position);
         foundComponent = true;
     }
 
@@ -55,28 +65,58 @@ void Actor::setPosition(const Vector2& position) const
     }
 }
 
+//===========================================================================//
+void Actor::setRotation(double rotation) const
+{
+    const size_t id = getId();
+    mStore->getTransform(id).rotation = rotation;
+    if (mStore->hasSprite(id))
+    {
+        mStore->getSprite(id).setRotation(rotation);
+    }
+    if (mStore->hasPhysics(id))
+    {
+        PhysicsBody& body = mStore->getPhysics(id);
+        body.setTransform(body.getPosition(), rotation);
+        body.wake();
+    }
+}
+
 //===========================================================================//
 Vector2 Actor::getPosition() const
 {
-    if (mSprite)
+    const size_t id = getId();
+    if (mStore->hasPhysics(id))
     {
-        return mSprite->get().getPosition();
+        return mStore->getPhysics(id).getPosition();
     }
-    else if (mPhysics)
+    else if (mStore->hasSprite(id))
     {
-        return mPhysics->getPosition();
+        return mStore->getTransform(id).position;
     }
 
     Logger::warn("Actor has no positional components.");
     return Vector2();
 }
 
+//===========================================================================//
+Vector2 Actor::getRenderPosition() const
+{
+    const size_t id = getId();
+    if (mStore->hasSprite(id))
+    {
+        return mStore->getTransform(id).position;
+    }
+    return getPosition();
+}
+
 //===========================================================================//
 Vector2 Actor::getVelocity() const
 {
-    if (mPhysics)
+    const size_t id = getId();
+    if (mStore->hasPhysics(id))
     {
-        return mPhysics->get().GetLinearVelocity();
+        return mStore->getPhysics(id).get().GetLinearVelocity();
     }
     Logger::warn("Actor has no physics component for velocity.");
     return Vector2();
@@ -85,44 +125,63 @@ Vector2 Actor::getVelocity() const
 //===========================================================================//
 void Actor::applyImpulse(const Vector2& impulse) const
 {
-    if (!mPhysics)
+    const size_t id = getId();
+    if (!mStore->hasPhysics(id))
     {
         Logger::warn("Actor has no phyiscs component to apply impulse to");
         return;
     }
 
-    mPhysics->get().ApplyLinearImpulse(
-            impulse.toThirdParty<b2Vec2>(),
-            mPhysics->get().GetWorldCenter(),
-            true);
+    PhysicsBody& physics = mStore->getPhysics(id);
+    physics.wake();
+    b2Body& body = physics.get();
+    body.ApplyLinearImpulse(impulse.toThirdParty<b2Vec2>(),
+                            body.GetWorldCenter(),
+                            true);
 }
 
 //===========================================================================//
 void Actor::applyForce(const Vector2& impulse) const
 {
-    if (!mPhysics)
+    const size_t id = getId();
+    if (!mStore->hasPhysics(id))
     {
         Logger::warn("Actor has no phyiscs component to apply force to");
         return;
     }
 
-    mPhysics->get().ApplyForce(
-            impulse.toThirdParty<b2Vec2>(),
-            mPhysics->get().GetWorldCenter(),
-            true);
+    PhysicsBody& physics = mStore->getPhysics(id);
+    physics.wake();
+    b2Body& body = physics.get();
+    body.ApplyForce(impulse.toThirdParty<b2Vec2>(),
+                    body.GetWorldCenter(),
+                    true);
+}
+
+//===========================================================================//
+void Actor::attach(const Actor& parent,
+                   const Vector2& offset,
+                   double rotation) const
+{
+    Transform local;
+    local.position = offset;
+    local.rotation = rotation;
+    mStore->setParent(getId(), parent.getHandle(), local);
+}
+
+//===========================================================================//
+void Actor::detach() const
+{
+    mStore->clearParent(getId());
 }
 
 //===========================================================================//
-void Actor::updateGraphicsWithPhysics() const
+size_t Actor::getId() const
 {
-    if (!mSprite || !mPhysics)
+    if (!mStore)
     {
-        Logger::warn("Attempting to update graphics with physics on an "
-                     "Actor with the proper components.");
-        return;
+        throw std::runtime_error("Attempting to use a null actor.");
     }
-    mSprite->get().setPosition(
-            mPhysics->getPosition().toThirdParty<sf::Vector2f>());
-    mSprite->get().setRotation(mPhysics->getRotation());
+    return mStore->getId(mHandle);
+}
 }
-}
\ No newline at end of file
@@ -0,0 +1,86 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#include <nyra/Arena.h>
+#include <stdexcept>
+#include <string>
+
+namespace nyra
+{
+//===========================================================================//
+Arena::Arena(size_t blockSize) :
+    mBlockSize(blockSize),
+    mBlock(0),
+    mOffset(0),
+    mUsed(0),
+    mHighWaterMark(0)
+{
+}
+
+//===========================================================================//
+void* Arena::allocate(size_t size, size_t alignment)
+{
+    if (size > mBlockSize)
+    {
+        throw std::runtime_error("Arena allocation of " +
+                                 std::to_string(size) +
+                                 " bytes is larger than a block.");
+    }
+
+    // Move to the next block when this one is full. Blocks are kept across
+    // resets so a new one is only made when the map needs more than ever.
+    size_t start = (mOffset + alignment - 1) & ~(alignment - 1);
+    if (mBlocks.empty() || start + size > mBlockSize)
+    {
+        if (!mBlocks.empty())
+        {
+            mUsed += mBlockSize - mOffset;
+            ++mBlock;
+        }
+        if (mBlock == mBlocks.size())
+        {
+            mBlocks.push_back(std::unique_ptr<char[]>(new char[mBlockSize]));
+        }
+        mOffset = 0;
+        start = 0;
+    }
+
+    char* memory = mBlocks[mBlock].get() + start;
+    mUsed += start + size - mOffset;
+    mOffset = start + size;
+    if (mUsed > mHighWaterMark)
+    {
+        mHighWaterMark = mUsed;
+    }
+    return memory;
+}
+
+//===========================================================================//
+void Arena::reset()
+{
+    mBlock = 0;
+    mOffset = 0;
+    mUsed = 0;
+    mHighWaterMark = 0;
+}
+}
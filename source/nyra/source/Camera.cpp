@@ -28,7 +28,6 @@ namespace nyra
 {
 //===========================================================================//
 Camera::Camera() :
-    mTarget(nullptr),
     mLerpSpeed(0.0)
 {
 }
@@ -38,29 +37,27 @@ void Camera::track(const Actor& target,
                    const Vector2& offset,
                    double lerpSpeed)
 {
-    mTarget = &target;
+    mTarget = target;
     mOffset = offset;
     mLerpSpeed = lerpSpeed;
 }
 
 //===========================================================================//
-void Camera::update(sf::RenderTarget& render)
+void Camera::update(sf::View& view)
 {
-    if (!mTarget)
+    if (!mTarget.isValid())
     {
         return;
     }
 
-    sf::View view = render.getView();
     sf::Vector2f center =
-            (mTarget->getPosition() + mOffset).toThirdParty<sf::Vector2f>();
+            (mTarget.getRenderPosition() + mOffset).toThirdParty<sf::Vector2f>();
     view.setCenter(center);
-    render.setView(view);
 }
 
 //===========================================================================//
 void Camera::reset()
 {
-    mTarget = nullptr;
+    mTarget = Actor();
 }
 }
\ No newline at end of file
@@ -0,0 +1,612 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#include <nyra/ComponentStore.h>
+#include <nyra/Constants.h>
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+//===========================================================================//
+static const size_t NOT_IN_QUERY = std::numeric_limits<size_t>::max();
+static const size_t NUM_COMPONENT_BITS = 3;
+}
+
+namespace nyra
+{
+//===========================================================================//
+const size_t ComponentStore::NO_SPRITE = std::numeric_limits<size_t>::max();
+const size_t ComponentStore::NO_POOL = std::numeric_limits<size_t>::max();
+const ComponentMask ComponentStore::SPRITE_MASK = 1 << 0;
+const ComponentMask ComponentStore::PHYSICS_MASK = 1 << 1;
+const ComponentMask ComponentStore::SCRIPT_MASK = 1 << 2;
+
+//===========================================================================//
+ComponentStore::ComponentStore(Graphics& graphics) :
+    mGraphics(graphics),
+    mHierarchyDirty(false)
+{
+}
+
+//===========================================================================//
+ActorHandle ComponentStore::addActor()
+{
+    const size_t id = mTransforms.size();
+
+    // Reuse a slot if one is free. Its generation was bumped when it
+    // was released.
+    uint32_t index;
+    if (!mFreeSlots.empty())
+    {
+        index = mFreeSlots.back();
+        mFreeSlots.pop_back();
+    }
+    else
+    {
+        index = static_cast<uint32_t>(mSlots.size());
+        Slot slot;
+        slot.generation = 1;
+        mSlots.push_back(slot);
+    }
+    Slot& slot = mSlots[index];
+    slot.alive = true;
+    slot.id = id;
+    const ActorHandle handle = makeActorHandle(index, slot.generation);
+
+    Transform transform;
+    transform.rotation = 0.0;
+    mTransforms.push_back(transform);
+    mSprites.push_back(NO_SPRITE);
+    mBodies.push_back(nullptr);
+    mScripts.push_back(nullptr);
+    mActive.push_back(true);
+    mPools.push_back(NO_POOL);
+    mSynced.push_back(false);
+    mParents.push_back(INVALID_ACTOR);
+    mLocals.push_back(transform);
+    mChildCounts.push_back(0);
+    mParentTransforms.push_back(transform);
+    mStale.push_back(true);
+    mMasks.push_back(0);
+    mHandles.push_back(handle);
+    return handle;
+}
+
+//===========================================================================//
+void ComponentStore::reserve(size_t count)
+{
+    const size_t size = mTransforms.size() + count;
+    mSlots.reserve(mSlots.size() + count);
+    mHandles.reserve(size);
+    mTransforms.reserve(size);
+    mSprites.reserve(size);
+    mBodies.reserve(size);
+    mScripts.reserve(size);
+    mActive.reserve(size);
+    mPools.reserve(size);
+    mSynced.reserve(size);
+    mParents.reserve(size);
+    mLocals.reserve(size);
+    mChildCounts.reserve(size);
+    mParentTransforms.reserve(size);
+    mStale.reserve(size);
+    mMasks.reserve(size);
+    mSpriteOwners.reserve(mSpriteOwners.size() + count);
+}
+
+//===========================================================================//
+size_t ComponentStore::getId(ActorHandle handle) const
+{
+    if (!isValid(handle))
+    {
+        throw std::runtime_error("Attempting to use a destroyed actor.");
+    }
+    return mSlots[getHandleIndex(handle)].id;
+}
+
+//===========================================================================//
+void ComponentStore::removeActor(ActorHandle handle)
+{
+    const size_t id = getId(handle);
+
+    // Release the sprite. The last sprite takes its index.
+    if (hasSprite(id))
+    {
+        const size_t sprite = mSprites[id];
+        const size_t lastSprite = mGraphics.getSpriteCount() - 1;
+        mGraphics.removeSprite(sprite);
+        if (sprite != lastSprite)
+        {
+            const size_t owner = mSpriteOwners[lastSprite];
+            mSprites[owner] = sprite;
+            mSpriteOwners[sprite] = owner;
+        }
+        mSpriteOwners.pop_back();
+    }
+
+    // Only removing part of a hierarchy changes its order
+    const bool inHierarchy =
+            mParents[id] != INVALID_ACTOR || mChildCounts[id] > 0;
+    if (isValid(mParents[id]))
+    {
+        --mChildCounts[mSlots[getHandleIndex(mParents[id])].id];
+    }
+
+    removeFromQueries(id);
+    releaseSlot(getHandleIndex(handle));
+
+    // Move the last actor into the hole
+    const size_t last = mTransforms.size() - 1;
+    if (id != last)
+    {
+        mTransforms[id] = mTransforms[last];
+        mSprites[id] = mSprites[last];
+        mBodies[id] = mBodies[last];
+        mScripts[id] = mScripts[last];
+        mActive[id] = mActive[last];
+        mPools[id] = mPools[last];
+        mSynced[id] = mSynced[last];
+        mParents[id] = mParents[last];
+        mLocals[id] = mLocals[last];
+        mChildCounts[id] = mChildCounts[last];
+        mParentTransforms[id] = mParentTransforms[last];
+        mStale[id] = mStale[last];
+        mMasks[id] = mMasks[last];
+        mHandles[id] = mHandles[last];
+
+        mSlots[getHandleIndex(mHandles[id])].id = id;
+        if (hasSprite(id))
+        {
+            mSpriteOwners[mSprites[id]] = id;
+        }
+    }
+
+    mTransforms.pop_back();
+    mSprites.pop_back();
+    mBodies.pop_back();
+    mScripts.pop_back();
+    mActive.pop_back();
+    mPools.pop_back();
+    mSynced.pop_back();
+    mParents.pop_back();
+    mLocals.pop_back();
+    mChildCounts.pop_back();
+    mParentTransforms.pop_back();
+    mStale.pop_back();
+    mMasks.pop_back();
+    mHandles.pop_back();
+
+    if (mHierarchy.empty())
+    {
+        return;
+    }
+    if (inHierarchy)
+    {
+        mHierarchyDirty = true;
+    }
+    else if (id != last && mParents[id] != INVALID_ACTOR)
+    {
+        // The moved child keeps its depth so only its id changes
+        auto iter = std::find(mHierarchy.begin(), mHierarchy.end(), last);
+        if (iter != mHierarchy.end())
+        {
+            *iter = id;
+        }
+    }
+}
+
+//===========================================================================//
+void ComponentStore::clear()
+{
+    // Slots are kept so their generations keep counting up
+    for (ActorHandle handle : mHandles)
+    {
+        releaseSlot(getHandleIndex(handle));
+    }
+
+    mHandles.clear();
+    mTransforms.clear();
+    mSprites.clear();
+    mBodies.clear();
+    mScripts.clear();
+    mActive.clear();
+    mPools.clear();
+    mSynced.clear();
+    mParents.clear();
+    mLocals.clear();
+    mChildCounts.clear();
+    mParentTransforms.clear();
+    mStale.clear();
+    mHierarchy.clear();
+    mHierarchyDirty = false;
+    mMasks.clear();
+    mSpriteOwners.clear();
+
+    // Queries and tags are kept so they can be used with the next map
+    for (Query& query : mQueries)
+    {
+        query.results.clear();
+        query.positions.clear();
+    }
+}
+
+//===========================================================================//
+void ComponentStore::setSprite(size_t id, size_t sprite)
+{
+    mSprites[id] = sprite;
+    if (sprite >= mSpriteOwners.size())
+    {
+        mSpriteOwners.resize(sprite + 1, NO_SPRITE);
+    }
+    mSpriteOwners[sprite] = id;
+    mStale[id] = true;
+    mMasks[id] |= SPRITE_MASK;
+    updateQueries(id);
+}
+
+//===========================================================================//
+void ComponentStore::setPhysics(size_t id, PhysicsBody& body)
+{
+    mBodies[id] = &body;
+    mSynced[id] = mParents[id] == INVALID_ACTOR &&
+                  body.get().GetType() != b2_staticBody;
+    body.setActor(mHandles[id]);
+    mStale[id] = true;
+    mMasks[id] |= PHYSICS_MASK;
+    updateQueries(id);
+}
+
+//===========================================================================//
+void ComponentStore::clearPhysics(size_t id)
+{
+    mBodies[id]->setActor(INVALID_ACTOR);
+    mBodies[id] = nullptr;
+    mSynced[id] = false;
+    mMasks[id] &= ~PHYSICS_MASK;
+    updateQueries(id);
+}
+
+//===========================================================================//
+void ComponentStore::setScript(size_t id, Script& script)
+{
+    mScripts[id] = &script;
+    mMasks[id] |= SCRIPT_MASK;
+    updateQueries(id);
+}
+
+//===========================================================================//
+void ComponentStore::setActive(size_t id, bool active)
+{
+    mActive[id] = active;
+    mStale[id] = true;
+    if (hasSprite(id))
+    {
+        getSprite(id).setVisible(active);
+    }
+    updateQueries(id);
+}
+
+//===========================================================================//
+ComponentMask ComponentStore::getTagMask(const std::string& tag)
+{
+    auto iter = mTags.find(tag);
+    if (iter == mTags.end())
+    {
+        const size_t bit = NUM_COMPONENT_BITS + mTags.size();
+        if (bit >= sizeof(ComponentMask) * 8)
+        {
+            throw std::runtime_error("Too many tags to add: " + tag);
+        }
+        iter = mTags.insert(std::make_pair(
+                tag, static_cast<ComponentMask>(1) << bit)).first;
+    }
+    return iter->second;
+}
+
+//===========================================================================//
+void ComponentStore::addTags(size_t id, ComponentMask tags)
+{
+    mMasks[id] |= tags;
+    updateQueries(id);
+}
+
+//===========================================================================//
+size_t ComponentStore::addQuery(ComponentMask mask)
+{
+    for (size_t ii = 0; ii < mQueries.size(); ++ii)
+    {
+        if (mQueries[ii].mask == mask)
+        {
+            return ii;
+        }
+    }
+
+    Query query;
+    query.mask = mask;
+    mQueries.push_back(query);
+
+    // Fill the new query once. It is kept up to date from here on.
+    for (size_t id = 0; id < mMasks.size(); ++id)
+    {
+        updateQueries(id);
+    }
+    return mQueries.size() - 1;
+}
+
+//===========================================================================//
+void ComponentStore::updateQueries(size_t id)
+{
+    for (Query& query : mQueries)
+    {
+        setInQuery(query,
+                   id,
+                   mActive[id] && (mMasks[id] & query.mask) == query.mask);
+    }
+}
+
+//===========================================================================//
+void ComponentStore::removeFromQueries(size_t id)
+{
+    for (Query& query : mQueries)
+    {
+        setInQuery(query, id, false);
+    }
+}
+
+//===========================================================================//
+void ComponentStore::setInQuery(Query& query, size_t id, bool matches)
+{
+    const ActorHandle handle = mHandles[id];
+    const uint32_t slot = getHandleIndex(handle);
+    if (slot >= query.positions.size())
+    {
+        query.positions.resize(mSlots.size(), NOT_IN_QUERY);
+    }
+
+    size_t& position = query.positions[slot];
+    if (matches && position == NOT_IN_QUERY)
+    {
+        position = query.results.size();
+        query.results.push_back(handle);
+    }
+    else if (!matches && position != NOT_IN_QUERY)
+    {
+        // Swap with the last result to keep the list dense
+        const ActorHandle moved = query.results.back();
+        query.results[position] = moved;
+        query.positions[getHandleIndex(moved)] = position;
+        query.results.pop_back();
+        position = NOT_IN_QUERY;
+    }
+}
+
+//===========================================================================//
+void ComponentStore::syncGraphicsWithPhysics(
+        const std::vector<PhysicsBody*>& bodies,
+        double alpha)
+{
+    for (const PhysicsBody* awake : bodies)
+    {
+        const ActorHandle handle = awake->getActor();
+        if (!isValid(handle))
+        {
+            continue;
+        }
+
+        const size_t id = mSlots[getHandleIndex(handle)].id;
+        if (!mActive[id] || !mSynced[id])
+        {
+            continue;
+        }
+
+        const PhysicsBody& body = *awake;
+        Transform& transform = mTransforms[id];
+        transform.position = body.getInterpolatedPosition(alpha);
+        transform.rotation = body.getInterpolatedRotation(alpha);
+
+        if (hasSprite(id))
+        {
+            Sprite& sprite = mGraphics.getSprite(mSprites[id]);
+            sprite.setPosition(
+                    transform.position.toThirdParty<sf::Vector2f>());
+            sprite.setRotation(transform.rotation);
+        }
+    }
+}
+
+//===========================================================================//
+void ComponentStore::setParent(size_t id,
+                               ActorHandle parent,
+                               const Transform& local)
+{
+    // Walk up from the new parent to make sure this doesn't make a loop
+    ActorHandle ancestor = parent;
+    while (ancestor != INVALID_ACTOR)
+    {
+        const size_t ancestorId = getId(ancestor);
+        if (ancestorId == id)
+        {
+            throw std::runtime_error(
+                    "Attempting to attach an actor to itself or one of its "
+                    "children.");
+        }
+        ancestor = isValid(mParents[ancestorId]) ?
+                mParents[ancestorId] : INVALID_ACTOR;
+    }
+
+    if (isValid(mParents[id]))
+    {
+        --mChildCounts[mSlots[getHandleIndex(mParents[id])].id];
+    }
+    ++mChildCounts[getId(parent)];
+    mParents[id] = parent;
+    mLocals[id] = local;
+    mSynced[id] = false;
+    mStale[id] = true;
+    mHierarchyDirty = true;
+}
+
+//===========================================================================//
+void ComponentStore::clearParent(size_t id)
+{
+    if (mParents[id] == INVALID_ACTOR)
+    {
+        return;
+    }
+
+    if (isValid(mParents[id]))
+    {
+        --mChildCounts[mSlots[getHandleIndex(mParents[id])].id];
+    }
+    mParents[id] = INVALID_ACTOR;
+    mHierarchyDirty = true;
+    if (hasPhysics(id))
+    {
+        PhysicsBody& body = *mBodies[id];
+        mSynced[id] = body.get().GetType() != b2_staticBody;
+        body.wake();
+    }
+}
+
+//===========================================================================//
+void ComponentStore::addDescendants(std::vector<ActorHandle>& handles)
+{
+    sortHierarchy();
+    if (mHierarchy.empty())
+    {
+        return;
+    }
+
+    // Parents come first so one pass finds every generation
+    std::unordered_set<ActorHandle> family(handles.begin(), handles.end());
+    for (size_t id : mHierarchy)
+    {
+        if (family.count(mParents[id]) && family.insert(mHandles[id]).second)
+        {
+            handles.push_back(mHandles[id]);
+        }
+    }
+}
+
+//===========================================================================//
+void ComponentStore::propagateTransforms()
+{
+    sortHierarchy();
+    for (size_t id : mHierarchy)
+    {
+        const ActorHandle parent = mParents[id];
+        if (!mActive[id] || !isValid(parent))
+        {
+            continue;
+        }
+
+        // Nothing has to be moved if the parent is where it was last time
+        const Transform& parentTransform =
+                mTransforms[mSlots[getHandleIndex(parent)].id];
+        Transform& placedFrom = mParentTransforms[id];
+        if (!mStale[id] &&
+            parentTransform.position == placedFrom.position &&
+            parentTransform.rotation == placedFrom.rotation)
+        {
+            continue;
+        }
+        placedFrom = parentTransform;
+        mStale[id] = false;
+
+        const Transform& local = mLocals[id];
+        const double radians =
+                parentTransform.rotation * Constants::DEGREES_TO_RADIANS;
+        const double cosine = std::cos(radians);
+        const double sine = std::sin(radians);
+
+        Transform& transform = mTransforms[id];
+        transform.position = parentTransform.position + Vector2(
+                local.position.x * cosine - local.position.y * sine,
+                local.position.x * sine + local.position.y * cosine);
+        transform.rotation = parentTransform.rotation + local.rotation;
+
+        if (hasSprite(id))
+        {
+            Sprite& sprite = mGraphics.getSprite(mSprites[id]);
+            sprite.setPosition(
+                    transform.position.toThirdParty<sf::Vector2f>());
+            sprite.setRotation(transform.rotation);
+        }
+        if (hasPhysics(id))
+        {
+            mBodies[id]->setTransform(transform.position, transform.rotation);
+        }
+    }
+}
+
+//===========================================================================//
+void ComponentStore::sortHierarchy()
+{
+    if (!mHierarchyDirty)
+    {
+        return;
+    }
+
+    // Sort children by how deep they are so parents are placed first
+    std::vector<std::pair<size_t, size_t> > depths;
+    for (size_t id = 0; id < mParents.size(); ++id)
+    {
+        size_t depth = 0;
+        for (ActorHandle parent = mParents[id];
+             isValid(parent);
+             parent = mParents[mSlots[getHandleIndex(parent)].id])
+        {
+            ++depth;
+        }
+        if (depth > 0)
+        {
+            depths.push_back(std::make_pair(depth, id));
+        }
+    }
+    std::sort(depths.begin(), depths.end());
+
+    mHierarchy.clear();
+    for (const auto& depth : depths)
+    {
+        mHierarchy.push_back(depth.second);
+    }
+    mHierarchyDirty = false;
+}
+
+//===========================================================================//
+void ComponentStore::releaseSlot(uint32_t index)
+{
+    // Bumping the generation makes every handle to this slot stale
+    Slot& slot = mSlots[index];
+    slot.alive = false;
+    if (++slot.generation == 0)
+    {
+        slot.generation = 1;
+    }
+    mFreeSlots.push_back(index);
+}
+}
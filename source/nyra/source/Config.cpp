@@ -23,19 +23,29 @@
  */
 #include <nyra/Config.h>
 #include <nyra/Constants.h>
+#include <thread>
 
 namespace
 {
 static const bool DEBUG = false;
 static const std::string DATA_DIR(nyra::Constants::APP_PATH + "../data/");
 static const double FRAMES_PER_SECOND = 60.0;
+static const double STEPS_PER_SECOND = 60.0;
+static const size_t MAX_STEPS_PER_FRAME = 5;
 static const std::string TITLE = "Nyra Engine";
 static const nyra::Vector2 WINDOW_POSITION(0.0, 0.0);
 static const nyra::Vector2 WINDOW_SIZE(1920, 1080);
 static const bool FULLSCREEN = false;
 static const bool VSYNC = false;
+static const bool HEADLESS = false;
+static const bool PIPELINED = false;
 static const nyra::Vector2 GRAVITY(0.0, 200.0);
+static const bool MERGE_STATIC_TILES = true;
+static const size_t PHYSICS_THREADS =
+        std::thread::hardware_concurrency() > 1 ?
+                std::thread::hardware_concurrency() - 1 : 0;
 static const std::string DEFAULT_MAP("");
+static const std::string PROFILE_OUTPUT("");
 }
 
 namespace nyra
@@ -45,13 +55,20 @@ Config::Config() :
     debug(DEBUG),
     dataDir(DATA_DIR),
     framesPerSecond(FRAMES_PER_SECOND),
+    stepsPerSecond(STEPS_PER_SECOND),
+    maxStepsPerFrame(MAX_STEPS_PER_FRAME),
     title(TITLE),
     windowPosition(WINDOW_POSITION),
     windowSize(WINDOW_SIZE),
     fullscreen(FULLSCREEN),
     vsync(VSYNC),
+    headless(HEADLESS),
+    pipelined(PIPELINED),
     gravity(GRAVITY),
-    defaultMap(DEFAULT_MAP)
+    physicsThreads(PHYSICS_THREADS),
+    mergeStaticTiles(MERGE_STATIC_TILES),
+    defaultMap(DEFAULT_MAP),
+    profileOutput(PROFILE_OUTPUT)
 {
 }
 }
@@ -0,0 +1,148 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#include <nyra/ContactListener.h>
+#include <nyra/PhysicsBody.h>
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+//===========================================================================//
+nyra::ActorHandle getActor(const b2Fixture& fixture)
+{
+    return static_cast<const nyra::PhysicsBody*>(
+            fixture.GetBody()->GetUserData())->getActor();
+}
+}
+
+namespace nyra
+{
+//===========================================================================//
+ContactListener::ContactListener(size_t capacity) :
+    mBegunSorted(true)
+{
+    mContacts.reserve(capacity);
+    mBegun.reserve(capacity);
+}
+
+//===========================================================================//
+void ContactListener::BeginContact(b2Contact* contact)
+{
+    record(contact, true);
+}
+
+//===========================================================================//
+void ContactListener::EndContact(b2Contact* contact)
+{
+    record(contact, false);
+}
+
+//===========================================================================//
+void ContactListener::PostSolve(b2Contact* contact,
+                                const b2ContactImpulse* impulse)
+{
+    // This is called for every touching contact each step. Only the few
+    // that began this step are looked up. They are sorted in place the
+    // first time they are needed so the lookup never allocates.
+    if (mBegun.empty())
+    {
+        return;
+    }
+    if (!mBegunSorted)
+    {
+        std::sort(mBegun.begin(), mBegun.end());
+        mBegunSorted = true;
+    }
+
+    // Box2D may reuse the memory of an ended contact within the same step.
+    // The last match is the newest record.
+    const auto iter = std::upper_bound(
+            mBegun.begin(),
+            mBegun.end(),
+            std::make_pair(contact, std::numeric_limits<size_t>::max()));
+    if (iter == mBegun.begin() || (iter - 1)->first != contact)
+    {
+        return;
+    }
+
+    float32 total = 0.0f;
+    for (int32 ii = 0; ii < impulse->count; ++ii)
+    {
+        total += impulse->normalImpulses[ii];
+    }
+    Contact& record = mContacts[(iter - 1)->second];
+    record.impulse = std::max(record.impulse, total);
+}
+
+//===========================================================================//
+void ContactListener::clear()
+{
+    mContacts.clear();
+    mBegun.clear();
+    mBegunSorted = true;
+}
+
+//===========================================================================//
+void ContactListener::record(b2Contact* contact, bool begin)
+{
+    Contact record;
+    record.first = getActor(*contact->GetFixtureA());
+    record.second = getActor(*contact->GetFixtureB());
+    if (record.first == INVALID_ACTOR && record.second == INVALID_ACTOR)
+    {
+        return;
+    }
+    record.begin = begin;
+    record.impulse = 0.0f;
+
+    // Sensors and contacts that are ending may not have any points. The
+    // middle of the two bodies is used instead.
+    const b2Manifold* manifold = contact->GetManifold();
+    if (manifold->pointCount > 0)
+    {
+        b2WorldManifold worldManifold;
+        contact->GetWorldManifold(&worldManifold);
+        record.point.SetZero();
+        for (int32 ii = 0; ii < manifold->pointCount; ++ii)
+        {
+            record.point += worldManifold.points[ii];
+        }
+        record.point *= 1.0f / manifold->pointCount;
+    }
+    else
+    {
+        const b2Vec2& first = contact->GetFixtureA()->GetBody()->GetPosition();
+        const b2Vec2& second =
+                contact->GetFixtureB()->GetBody()->GetPosition();
+        record.point = 0.5f * (first + second);
+    }
+
+    if (begin)
+    {
+        mBegun.push_back(std::make_pair(contact, mContacts.size()));
+        mBegunSorted = false;
+    }
+    mContacts.push_back(record);
+}
+}
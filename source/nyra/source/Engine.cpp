@@ -22,34 +22,61 @@
  * IN THE SOFTWARE.
  */
 #include <nyra/Engine.h>
-#include <nyra/JSONActor.h>
 #include <nyra/Logger.h>
 #include <nyra/JSONMap.h>
 #include <nyra/InputConstants.h>
+#include <nyra/Profiler.h>
+#include <nyra/FileSystem.h>
+
+namespace
+{
+//===========================================================================//
+static const size_t ARENA_BLOCK_SIZE = 1024 * 1024;
+}
 
 namespace nyra
 {
 //===========================================================================//
 Engine::Engine(const Config& config) :
     mConfig(config),
+    mProfiler(),
     mRenderPhysics(false),
     mElapsedTime(0.0),
     mTimePerFrame(1.0 / mConfig.framesPerSecond),
+    mAccumulator(0.0),
+    mTimePerStep(1.0 / mConfig.stepsPerSecond),
+    mInput(mConfig.headless),
+    mArena(ARENA_BLOCK_SIZE),
     mGraphics(mConfig.title,
               mConfig.windowPosition,
               mConfig.windowSize,
               mConfig.fullscreen,
-              mConfig.vsync),
+              mConfig.vsync,
+              mConfig.headless,
+              mConfig.pipelined),
     mPhysicsRenderer(mGraphics.getWindow()),
     mPhysics(mConfig.gravity,
-             mPhysicsRenderer),
-    mScript(this)
+             mConfig.physics,
+             mConfig.physicsThreads,
+             mPhysicsRenderer,
+             mArena),
+    mScript(this, mArena),
+    mComponents(mGraphics),
+    mPrefabs(mConfig.dataDir, mGraphics, mComponents)
 {
+    Profiler::registerProfiler(&mProfiler);
     Logger::info("Engine initialized");
     mPhysicsRenderer.setRender(true);
     mInput.registerInput("render physics",
                          std::vector<size_t>(1, Keyboard::NUM_1));
 
+    // Use the packed textures if the atlas tool has been run
+    const std::string atlas(mConfig.dataDir + "/textures/atlas.json");
+    if (fileExists(atlas))
+    {
+        mGraphics.loadAtlas(atlas);
+    }
+
     // Check for a default map
     if (!mConfig.defaultMap.empty())
     {
@@ -58,58 +85,143 @@ Engine::Engine(const Config& config) :
 }
 
 //===========================================================================//
-bool Engine::update()
+Engine::~Engine()
 {
-    const double deltaTime = mTimer.restart().asSeconds();
-
-    if (mGraphics.getVsyncFlag())
-    {
-        return tick(deltaTime);
-    }
-    else
+    if (!mConfig.profileOutput.empty())
     {
-        mElapsedTime += deltaTime;
-        if (mElapsedTime >= mTimePerFrame)
+        Logger::info("Writing profile trace: " + mConfig.profileOutput);
+        try
         {
-            if (!tick(mTimePerFrame))
-            {
-                return false;
-            }
-            mElapsedTime -= mTimePerFrame;
+            getProfiler().dumpTrace(mConfig.profileOutput);
         }
-        if (mElapsedTime >= mTimePerFrame)
+        catch (const std::exception& ex)
         {
-            const size_t skippedFrames =
-                    static_cast<size_t>(mElapsedTime / mTimePerFrame);
-            Logger::warn("FPS is too high, skipping " +
-                         std::to_string(skippedFrames) + " frames.");
-            mElapsedTime -= mTimePerFrame * skippedFrames;
+            Logger::error(ex.what());
         }
     }
 
-    return true;
+    // Threads still running record into the fallback until they stop.
+    // The profiler is declared before them so it outlives them anyway.
+    Profiler::registerProfiler(nullptr);
 }
 
 //===========================================================================//
-bool Engine::tick(double deltaTime)
+bool Engine::update()
 {
+    // Headless runs on a synthetic clock. Every update is exactly one
+    // step so the simulation runs as fast as the CPU allows.
+    if (mGraphics.getHeadlessFlag())
+    {
+        return tick(mTimePerStep);
+    }
+
+    mElapsedTime += mTimer.restart().asSeconds();
+
+    // Without vsync the render rate is capped by framesPerSecond
+    if (!mGraphics.getVsyncFlag() && mElapsedTime < mTimePerFrame)
+    {
+        return true;
+    }
+
+    const double frameTime = mElapsedTime;
+    mElapsedTime = 0.0;
+    return tick(frameTime);
+}
+
+//===========================================================================//
+bool Engine::tick(double frameTime)
+{
+    NYRA_PROFILE("frame");
+
     if (!mGraphics.clear())
     {
         return false;
     }
 
-    mScript.update(deltaTime);
+    // Run as many fixed steps as the frame time allows
+    mAccumulator += frameTime;
+    size_t steps = 0;
+    while (mAccumulator >= mTimePerStep)
+    {
+        if (steps == mConfig.maxStepsPerFrame)
+        {
+            const size_t droppedSteps =
+                    static_cast<size_t>(mAccumulator / mTimePerStep);
+            Logger::warn("Simulation is falling behind, dropping " +
+                         std::to_string(droppedSteps) + " steps.");
+            mAccumulator -= mTimePerStep * droppedSteps;
+            break;
+        }
 
-    mPhysics.update(deltaTime);
+        step(mTimePerStep);
+        mAccumulator -= mTimePerStep;
+        ++steps;
+    }
+
+    // Deliver everything the scripts and physics sent this frame
+    {
+        NYRA_PROFILE("events");
+        postContacts();
+        mEvents.dispatch(mComponents);
+    }
+
+    // Place dynamic actors between the last two steps
+    const double alpha = mAccumulator / mTimePerStep;
+    {
+        NYRA_PROFILE("sync");
+        mComponents.syncGraphicsWithPhysics(mPhysics.getAwakeBodies(),
+                                            alpha);
+        mPhysics.pruneAwakeBodies();
+    }
 
-    // Update dynamic actors
-    for (auto actor : mDynamicActors)
+    // Children follow their parents after everything else has moved
     {
-        actor->updateGraphicsWithPhysics();
+        NYRA_PROFILE("hierarchy");
+        mComponents.propagateTransforms();
     }
 
     // Update the camera
-    mCamera.update(mGraphics.getWindow());
+    {
+        NYRA_PROFILE("camera");
+        mCamera.update(mGraphics.getView());
+    }
+
+    {
+        NYRA_PROFILE("render");
+        mGraphics.render();
+
+        // Check for physics rendering. The window belongs to the render
+        // thread when pipelined.
+        if (mConfig.debug && mRenderPhysics && !mGraphics.getPipelinedFlag())
+        {
+            mPhysics.render();
+        }
+    }
+
+    {
+        NYRA_PROFILE("present");
+        mGraphics.present();
+    }
+
+    // Nothing is iterating over the components now
+    despawnPendingActors();
+    destroyPendingActors();
+
+    return true;
+}
+
+//===========================================================================//
+void Engine::step(double deltaTime)
+{
+    {
+        NYRA_PROFILE("script");
+        mScript.update(deltaTime);
+    }
+
+    {
+        NYRA_PROFILE("physics");
+        mPhysics.update(deltaTime);
+    }
 
     // Check for physics rendering
     if (mConfig.debug && mInput.buttonPressed("render physics"))
@@ -121,18 +233,10 @@ bool Engine::tick(double deltaTime)
     }
 
     // update the input
-    mInput.update();
-
-    mGraphics.render();
-
-    // Check for physics rendering
-    if (mConfig.debug && mRenderPhysics)
     {
-        mPhysics.render();
+        NYRA_PROFILE("input");
+        mInput.update();
     }
-    mGraphics.present();
-
-    return true;
 }
 
 //===========================================================================//
@@ -140,10 +244,218 @@ void Engine::reset()
 {
     mScript.reset();
     mPhysics.reset();
+
+    // Prefabs hold textures so they go before the graphics purge them
+    mPrefabs.clear();
     mGraphics.reset();
-    mDynamicActors.clear();
-    mActors.clear();
+    mComponents.clear();
+    mEvents.clear();
+    mPendingDestroy.clear();
+    mPendingDespawn.clear();
+    mPools.clear();
+    mPoolIndices.clear();
     mCamera.reset();
+    mAccumulator = 0.0;
+
+    // Everything in the arena has been destroyed above
+    Logger::debug("Map arena high water mark: " +
+                  std::to_string(mArena.getHighWaterMark()) + " bytes");
+    mArena.reset();
+}
+
+//===========================================================================//
+void Engine::destroyActor(const Actor& actor)
+{
+    mPendingDestroy.push_back(actor.getHandle());
+}
+
+//===========================================================================//
+void Engine::destroyPendingActors()
+{
+    if (mPendingDestroy.empty())
+    {
+        return;
+    }
+
+    NYRA_PROFILE("destroy");
+
+    // Children go with their parents
+    mComponents.addDescendants(mPendingDestroy);
+    for (ActorHandle handle : mPendingDestroy)
+    {
+        // The same actor may have been queued more than once
+        if (!mComponents.isValid(handle))
+        {
+            continue;
+        }
+
+        const size_t id = mComponents.getId(handle);
+        if (mComponents.hasScript(id))
+        {
+            mScript.removeScript(mComponents.getScript(id));
+        }
+        if (mComponents.hasPhysics(id))
+        {
+            mPhysics.removeBody(mComponents.getPhysics(id));
+        }
+        mComponents.removeActor(handle);
+    }
+    mPendingDestroy.clear();
+}
+
+//===========================================================================//
+void Engine::prewarm(const std::string& filename, size_t count)
+{
+    const size_t pool = getPool(filename);
+    mPools[pool].reserve(mPools[pool].size() + count);
+    for (size_t ii = 0; ii < count; ++ii)
+    {
+        const Actor actor = addActor(filename);
+        const size_t id = mComponents.getId(actor.getHandle());
+        mComponents.setPool(id, pool);
+        setActorActive(id, false);
+        mPools[pool].push_back(actor.getHandle());
+    }
+}
+
+//===========================================================================//
+Actor Engine::spawn(const std::string& filename, const Vector2& position)
+{
+    const size_t pool = getPool(filename);
+    std::vector<ActorHandle>& available = mPools[pool];
+
+    // Pooled actors may have been destroyed while they waited
+    ActorHandle handle = INVALID_ACTOR;
+    while (!available.empty() && !mComponents.isValid(handle))
+    {
+        handle = available.back();
+        available.pop_back();
+    }
+
+    size_t id;
+    if (mComponents.isValid(handle))
+    {
+        id = mComponents.getId(handle);
+        setActorActive(id, true);
+    }
+    else
+    {
+        Logger::debug("Pool is empty, creating: " + filename);
+        handle = addActor(filename).getHandle();
+        id = mComponents.getId(handle);
+        mComponents.setPool(id, pool);
+    }
+
+    // Only reset what gameplay can change
+    const Actor actor(mComponents, handle);
+    if (mComponents.hasPhysics(id))
+    {
+        mComponents.getPhysics(id).resetMotion();
+    }
+    if (mComponents.hasSprite(id))
+    {
+        mComponents.getSprite(id).setRotation(0.0f);
+        mComponents.getTransform(id).rotation = 0.0;
+    }
+    actor.setPosition(position);
+    if (mComponents.hasScript(id))
+    {
+        mComponents.getScript(id).call("init");
+    }
+    return actor;
+}
+
+//===========================================================================//
+void Engine::despawn(const Actor& actor)
+{
+    mPendingDespawn.push_back(actor.getHandle());
+}
+
+//===========================================================================//
+void Engine::despawnPendingActors()
+{
+    if (mPendingDespawn.empty())
+    {
+        return;
+    }
+
+    NYRA_PROFILE("despawn");
+    for (ActorHandle handle : mPendingDespawn)
+    {
+        if (!mComponents.isValid(handle))
+        {
+            continue;
+        }
+
+        const size_t id = mComponents.getId(handle);
+        const size_t pool = mComponents.getPool(id);
+        if (pool == ComponentStore::NO_POOL)
+        {
+            mPendingDestroy.push_back(handle);
+        }
+        else if (mComponents.isActive(id))
+        {
+            setActorActive(id, false);
+            mPools[pool].push_back(handle);
+        }
+    }
+    mPendingDespawn.clear();
+}
+
+//===========================================================================//
+size_t Engine::getPool(const std::string& filename)
+{
+    auto iter = mPoolIndices.find(filename);
+    if (iter == mPoolIndices.end())
+    {
+        iter = mPoolIndices.insert(
+                std::make_pair(filename, mPools.size())).first;
+        mPools.push_back(std::vector<ActorHandle>());
+    }
+    return iter->second;
+}
+
+//===========================================================================//
+void Engine::setActorActive(size_t id, bool active)
+{
+    // Children are pooled along with their parents
+    mFamily.assign(1, mComponents.getHandle(id));
+    mComponents.addDescendants(mFamily);
+    for (ActorHandle handle : mFamily)
+    {
+        setComponentsActive(mComponents.getId(handle), active);
+    }
+}
+
+//===========================================================================//
+void Engine::setComponentsActive(size_t id, bool active)
+{
+    mComponents.setActive(id, active);
+    if (mComponents.hasPhysics(id))
+    {
+        PhysicsBody& body = mComponents.getPhysics(id);
+        body.get().SetActive(active);
+        if (active)
+        {
+            body.wake();
+        }
+    }
+    if (mComponents.hasScript(id))
+    {
+        mScript.setActive(mComponents.getScript(id), active);
+    }
+}
+
+//===========================================================================//
+size_t Engine::addQuery(ComponentMask components,
+                        const std::vector<std::string>& tags)
+{
+    ComponentMask mask = components;
+    for (const std::string& tag : tags)
+    {
+        mask |= mComponents.getTagMask(tag);
+    }
+    return mComponents.addQuery(mask);
 }
 
 //===========================================================================//
@@ -153,11 +465,49 @@ void Engine::loadMap(const std::string& filename)
     const std::string pathname(mConfig.dataDir + "/maps/" + filename + ".json");
     Logger::info("Loading map: " + pathname);
     const JSONMap map(pathname);
-    for (const auto& actor : map.actors)
+
+    // Sectors decide which world each body is created in
+    std::vector<Vector2> sectors;
+    for (const auto& sector : map.sectors)
+    {
+        sectors.push_back(sector.lower);
+        sectors.push_back(sector.upper);
+    }
+    mPhysics.setSectors(sectors);
+
+    // Consecutive instances of the same file are created in bulk. Runs are
+    // not merged across the map so actors keep the map's creation order,
+    // which decides how their sprites are layered.
+    std::vector<ActorHandle> handles;
+    std::vector<Vector2> positions;
+    std::vector<double> rotations;
+    size_t start = 0;
+    while (start < map.actors.size())
+    {
+        const std::string& runFile = map.actors[start].filename;
+        positions.clear();
+        rotations.clear();
+        size_t end = start;
+        while (end < map.actors.size() &&
+               map.actors[end].filename == runFile)
+        {
+            positions.push_back(map.actors[end].position);
+            rotations.push_back(map.actors[end].rotation);
+            ++end;
+        }
+        addActors(runFile, positions, rotations, handles);
+        start = end;
+    }
+
+    if (mConfig.mergeStaticTiles)
+    {
+        mergeStaticTiles(handles);
+    }
+
+    // Pooled actors stay inactive until they are spawned
+    for (const auto& pool : map.pools)
     {
-        Actor& created = addActor(actor.filename);
-        created.setPosition(actor.position);
-        //created.setRotation(actor.rotation);
+        prewarm(pool.filename, pool.count);
     }
 
     // Tell all the actors everything is loaded
@@ -172,103 +522,185 @@ void Engine::addGUI(const std::string& filename)
 }
 
 //===========================================================================//
-Sprite& Engine::addSprite(const std::string& filename)
+Actor Engine::addActor(const std::string& filename)
 {
-    const std::string pathname(mConfig.dataDir + "/textures/" + filename + ".png");
-    return mGraphics.addSprite(pathname);
+    // Every instance of a file shares one parsed prefab
+    return addActor(mPrefabs.get(filename));
 }
 
 //===========================================================================//
-Actor& Engine::addActor(const std::string& filename)
+void Engine::addActors(const std::string& filename,
+                       const std::vector<Vector2>& positions,
+                       const std::vector<double>& rotations,
+                       std::vector<ActorHandle>& handles)
 {
-    // Parse JSON
-    const std::string pathname(mConfig.dataDir + "/actors/" + filename + ".json");
-    JSONActor json(pathname);
-
-    mActors.push_back(std::unique_ptr<Actor>(new Actor()));
-    Actor& actor = *mActors.back();
+    if (!rotations.empty() && rotations.size() != positions.size())
+    {
+        throw std::runtime_error(
+                "Each actor needs a rotation when adding: " + filename);
+    }
 
-    // Check for a sprite
-    if (json.sprite.get())
+    // Make room for everything once rather than once per actor
+    const Prefab& prefab = mPrefabs.get(filename);
+    const size_t count = positions.size();
+    mComponents.reserve(count * (prefab.children.size() + 1));
+    if (prefab.sprite.get())
+    {
+        mGraphics.reserveSprites(count);
+    }
+    if (prefab.physics.get())
     {
-        Sprite& sprite = addSprite(json.sprite->filename);
+        mPhysics.reserve(count);
+    }
+    if (prefab.script.get())
+    {
+        mScript.reserve(count);
+    }
+    handles.reserve(handles.size() + count);
 
-        if (json.sprite->origin.get())
-        {
-            sprite.get().setOrigin(
-                    json.sprite->origin->toThirdParty<sf::Vector2f>());
-        }
-        else
+    for (size_t ii = 0; ii < count; ++ii)
+    {
+        const Actor actor = addActor(prefab);
+        actor.setPosition(positions[ii]);
+        if (!rotations.empty())
         {
-            sprite.get().setOrigin(sf::Vector2f(
-                    (sprite.get().getTexture()->getSize().x / 2.0f),
-                    (sprite.get().getTexture()->getSize().y / 2.0f)));
+            actor.setRotation(rotations[ii]);
         }
-        actor.setSprite(sprite);
+        handles.push_back(actor.getHandle());
     }
+}
 
-    // Check for a script
-    if (json.script.get())
+//===========================================================================//
+void Engine::initActors(const std::vector<ActorHandle>& handles)
+{
+    for (ActorHandle handle : handles)
     {
-        Script* script = mScript.addScript(
-                json.script->module,
-                json.script->className,
-                &actor);
-
-        if (json.script->update.get())
+        if (!mComponents.isValid(handle))
         {
-            script->addMethod("update", (*json.script->update));
+            continue;
         }
-        if (json.script->init.get())
+
+        const size_t id = mComponents.getId(handle);
+        if (mComponents.hasScript(id))
         {
-            script->addMethod("init", (*json.script->init));
+            mComponents.getScript(id).call("init");
         }
-        actor.setScript(*script);
+    }
+}
+
+//===========================================================================//
+void Engine::postContacts()
+{
+    const std::vector<Contact>& contacts = mPhysics.getContacts();
+    if (contacts.empty())
+    {
+        return;
     }
 
-    // Check for phyics
-    if (json.physics.get())
+    const size_t beginType = mEvents.getType("contact begin");
+    const size_t endType = mEvents.getType("contact end");
+    for (const Contact& contact : contacts)
     {
-        PhysicsBody::Type type;
-        if (json.physics->type == "dynamic")
+        Event event;
+        event.type = contact.begin ? beginType : endType;
+        event.value = contact.impulse;
+        event.position = Vector2(contact.point) * Constants::PIXELS_PER_METER;
+
+        // Each actor is told about the other
+        if (contact.first != INVALID_ACTOR)
         {
-            type = PhysicsBody::DYNAMIC;
+            event.target = contact.first;
+            event.source = contact.second;
+            mEvents.post(event);
         }
-        else if (json.physics->type == "static")
+        if (contact.second != INVALID_ACTOR)
         {
-            type = PhysicsBody::STATIC;
+            event.target = contact.second;
+            event.source = contact.first;
+            mEvents.post(event);
         }
-        else
+    }
+    mPhysics.clearContacts();
+}
+
+//===========================================================================//
+void Engine::mergeStaticTiles(const std::vector<ActorHandle>& handles)
+{
+    // Anything a script could look up or move keeps its own body
+    std::vector<PhysicsBody*> bodies;
+    for (ActorHandle handle : handles)
+    {
+        const size_t id = mComponents.getId(handle);
+        if (!mComponents.hasPhysics(id) ||
+            mComponents.hasScript(id) ||
+            mComponents.hasTags(id) ||
+            mComponents.getParent(id) != INVALID_ACTOR ||
+            !Physics::canMerge(mComponents.getPhysics(id)))
         {
-            throw std::runtime_error(
-                    "Invalid physics type: " + json.physics->type);
+            continue;
         }
 
-        PhysicsBody& body = mPhysics.addBody(type);
+        bodies.push_back(&mComponents.getPhysics(id));
+        mComponents.clearPhysics(id);
+    }
+
+    mPhysics.mergeStaticBoxes(bodies);
+}
+
+//===========================================================================//
+Actor Engine::addActor(const Prefab& prefab)
+{
+    const ActorHandle handle = mComponents.addActor();
+    const size_t id = mComponents.getId(handle);
+    if (prefab.tags)
+    {
+        mComponents.addTags(id, prefab.tags);
+    }
+
+    // Check for a sprite
+    if (prefab.sprite.get())
+    {
+        const size_t index = mGraphics.addSprite(prefab.sprite->texture);
+        mGraphics.getSprite(index).setOrigin(prefab.sprite->origin);
+        mComponents.setSprite(id, index);
+    }
+
+    // Check for a script
+    if (prefab.script.get())
+    {
+        Script* script = mScript.addScript(
+                prefab.script->module,
+                prefab.script->className,
+                handle);
 
-        for (const auto& shape : json.physics->shapes)
+        for (const auto& method : prefab.script->methods)
         {
-            if (shape.type == "box")
-            {
-                body.addBox(shape.size,
-                            shape.density,
-                            shape.friction);
-            }
-            else
-            {
-                throw std::runtime_error(
-                        "Invalid physics shape: " + shape.type);
-            }
+            script->addMethod(method.first, method.second);
         }
-        actor.setPhysics(body);
+        mComponents.setScript(id, *script);
+    }
 
-        // Check if this is a dynamic renderable object
-        if (json.physics->type != "static" && actor.hasSprite())
+    // Check for phyics
+    if (prefab.physics.get())
+    {
+        PhysicsBody& body = mPhysics.addBody(prefab.physics->type);
+        for (const auto& shape : prefab.physics->shapes)
         {
-            mDynamicActors.push_back(&actor);
+            body.addShape(*shape.shape, shape.density, shape.friction);
         }
+        mComponents.setPhysics(id, body);
+    }
+
+    // Children are built and attached with every instance
+    for (const auto& child : prefab.children)
+    {
+        Transform local;
+        local.position = child.offset;
+        local.rotation = child.rotation;
+        const ActorHandle childHandle = addActor(child.filename).getHandle();
+        mComponents.setParent(mComponents.getId(childHandle), handle, local);
     }
-    return *mActors.back();
+    return Actor(mComponents, handle);
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,180 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#include <nyra/EventBus.h>
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+//===========================================================================//
+void throwPythonError(const std::string& message)
+{
+    // Fetch the error
+    PyObject* type;
+    PyObject* value;
+    PyObject* traceback;
+    PyErr_Fetch(&type, &value, &traceback);
+    const nyra::AutoPy typeRef(type);
+    const nyra::AutoPy valueRef(value);
+    const nyra::AutoPy tracebackRef(traceback);
+
+    // Get the error message
+    std::string errorString = message;
+    if (value)
+    {
+        const nyra::AutoPy text(PyObject_Str(value));
+        if (text.get())
+        {
+            errorString += std::string(": ") + PyString_AsString(text.get());
+        }
+    }
+    throw std::runtime_error(errorString);
+}
+}
+
+namespace nyra
+{
+//===========================================================================//
+EventBus::EventBus()
+{
+}
+
+//===========================================================================//
+size_t EventBus::getType(const std::string& name)
+{
+    auto iter = mTypes.find(name);
+    if (iter == mTypes.end())
+    {
+        // The name is handed to every script so it is only made once
+        AutoPy typeName(PyString_FromString(name.c_str()));
+        if (!typeName.get())
+        {
+            throw std::runtime_error(
+                    "Unable to create Python string: " + name);
+        }
+        iter = mTypes.insert(std::make_pair(name, mTypeNames.size())).first;
+        mTypeNames.push_back(typeName);
+    }
+    return iter->second;
+}
+
+//===========================================================================//
+void EventBus::post(const Event& event,
+                    const std::vector<ActorHandle>& targets)
+{
+    mQueue.reserve(mQueue.size() + targets.size());
+    for (ActorHandle target : targets)
+    {
+        mQueue.push_back(event);
+        mQueue.back().target = target;
+    }
+}
+
+//===========================================================================//
+void EventBus::dispatch(ComponentStore& components)
+{
+    if (mQueue.empty())
+    {
+        return;
+    }
+
+    // Both queues keep their memory so nothing is allocated once they
+    // have grown. Anything posted from here on waits for the next frame.
+    mDispatching.swap(mQueue);
+    mQueue.clear();
+
+    // Group events by target. Ties are broken by the order they were
+    // posted. Sorting indices in place keeps this free of allocations.
+    mOrder.resize(mDispatching.size());
+    for (size_t ii = 0; ii < mOrder.size(); ++ii)
+    {
+        mOrder[ii] = ii;
+    }
+    const std::vector<Event>& events = mDispatching;
+    std::sort(mOrder.begin(),
+              mOrder.end(),
+              [&events](size_t first, size_t second)
+              {
+                  return events[first].target < events[second].target ||
+                         (events[first].target == events[second].target &&
+                          first < second);
+              });
+
+    size_t start = 0;
+    while (start < mOrder.size())
+    {
+        const ActorHandle target = mDispatching[mOrder[start]].target;
+        size_t end = start + 1;
+        while (end < mOrder.size() &&
+               mDispatching[mOrder[end]].target == target)
+        {
+            ++end;
+        }
+
+        if (components.isValid(target))
+        {
+            const size_t id = components.getId(target);
+            if (components.isActive(id) &&
+                components.hasScript(id) &&
+                components.getScript(id).hasMethod("events"))
+            {
+                // The argument tuple takes ownership of the list
+                PyObject* list = PyList_New(end - start);
+                if (!list)
+                {
+                    throwPythonError("Unable to create Python event list");
+                }
+                for (size_t ii = start; ii < end; ++ii)
+                {
+                    const Event& event = mDispatching[mOrder[ii]];
+                    PyObject* item = Py_BuildValue(
+                            "(OKddd)",
+                            mTypeNames[event.type].get(),
+                            static_cast<unsigned long long>(event.source),
+                            event.value,
+                            static_cast<double>(event.position.x),
+                            static_cast<double>(event.position.y));
+                    if (!item)
+                    {
+                        // Releases the events that were already added
+                        Py_DECREF(list);
+                        throwPythonError("Unable to create Python event");
+                    }
+                    PyList_SET_ITEM(list, ii - start, item);
+                }
+                components.getScript(id).call<PyObject*>("events", list);
+            }
+        }
+        start = end;
+    }
+    mDispatching.clear();
+}
+
+//===========================================================================//
+void EventBus::clear()
+{
+    mQueue.clear();
+    mDispatching.clear();
+}
+}
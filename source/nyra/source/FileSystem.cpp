@@ -25,6 +25,8 @@
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
+#include <limits.h>
+#include <stdlib.h>
 
 namespace nyra
 {
@@ -66,4 +68,15 @@ bool fileExists(const std::string& pathname)
         return false;
     }
 }
-}
\ No newline at end of file
+
+//===========================================================================//
+std::string canonicalPath(const std::string& pathname)
+{
+    char buffer[PATH_MAX];
+    if (!realpath(pathname.c_str(), buffer))
+    {
+        throw std::runtime_error("Unable to open file: " + pathname);
+    }
+    return buffer;
+}
+}
@@ -23,7 +23,56 @@
  */
 #include <nyra/Graphics.h>
 #include <nyra/Logger.h>
+#include <nyra/Profiler.h>
 #include <iostream>
+#include <algorithm>
+
+namespace
+{
+//===========================================================================//
+static const size_t VERTICES_PER_SPRITE = 4;
+static const float CULL_CELL_SIZE = 256.0f;
+
+//===========================================================================//
+void writeQuad(const sf::Sprite& sprite, sf::Vertex* quad)
+{
+    const sf::FloatRect bounds = sprite.getLocalBounds();
+    const sf::IntRect& rect = sprite.getTextureRect();
+    const sf::Transform& transform = sprite.getTransform();
+    const sf::Color& color = sprite.getColor();
+
+    const float left = static_cast<float>(rect.left);
+    const float top = static_cast<float>(rect.top);
+    const float right = left + rect.width;
+    const float bottom = top + rect.height;
+
+    quad[0] = sf::Vertex(transform.transformPoint(0.0f, 0.0f),
+                         color, sf::Vector2f(left, top));
+    quad[1] = sf::Vertex(transform.transformPoint(bounds.width, 0.0f),
+                         color, sf::Vector2f(right, top));
+    quad[2] = sf::Vertex(transform.transformPoint(bounds.width, bounds.height),
+                         color, sf::Vector2f(right, bottom));
+    quad[3] = sf::Vertex(transform.transformPoint(0.0f, bounds.height),
+                         color, sf::Vector2f(left, bottom));
+}
+
+//===========================================================================//
+sf::FloatRect getBounds(const sf::Vertex* quad)
+{
+    float left = quad[0].position.x;
+    float top = quad[0].position.y;
+    float right = left;
+    float bottom = top;
+    for (size_t ii = 1; ii < VERTICES_PER_SPRITE; ++ii)
+    {
+        left = std::min(left, quad[ii].position.x);
+        top = std::min(top, quad[ii].position.y);
+        right = std::max(right, quad[ii].position.x);
+        bottom = std::max(bottom, quad[ii].position.y);
+    }
+    return sf::FloatRect(left, top, right - left, bottom - top);
+}
+}
 
 namespace nyra
 {
@@ -32,32 +81,79 @@ Graphics::Graphics(const std::string& title,
                    const Vector2& position,
                    const Vector2& size,
                    bool fullscreen,
-                   bool vsync) :
+                   bool vsync,
+                   bool headless,
+                   bool pipelined) :
     mFrames(0),
     mVsync(vsync),
+    mHeadless(headless),
+    mPipelined(pipelined && !headless),
     mWindowTitle(title),
-    mWindow(sf::VideoMode(size.x, size.y), mWindowTitle + " 0 FPS",
-            fullscreen ? (sf::Style::Fullscreen) :
-                         (sf::Style::Close | sf::Style::Titlebar))
+    mView(sf::FloatRect(0.0f, 0.0f, size.x, size.y)),
+    mTextures(!headless),
+    mNextDrawOrder(0),
+    mGrid(CULL_CELL_SIZE),
+    mWriteSnapshot(0),
+    mReadSnapshot(1),
+    mSnapshotPending(false),
+    mRendering(false),
+    mStopRendering(false)
 {
+    if (mHeadless)
+    {
+        Logger::info("Graphics initialized in headless mode");
+        return;
+    }
+
+    mWindow.create(sf::VideoMode(size.x, size.y), mWindowTitle + " 0 FPS",
+                   fullscreen ? (sf::Style::Fullscreen) :
+                                (sf::Style::Close | sf::Style::Titlebar));
     mWindow.setPosition(position.toThirdParty<sf::Vector2i>());
     mWindow.setVerticalSyncEnabled(vsync);
+    mView = mWindow.getDefaultView();
+
+    if (mPipelined)
+    {
+        // The context can only be active on one thread at a time
+        mWindow.setActive(false);
+        mRenderThread = std::thread(&Graphics::renderLoop, this);
+        Logger::info("Graphics initialized with a render thread");
+        return;
+    }
     Logger::info("Graphics initialized");
 }
 
+//===========================================================================//
+Graphics::~Graphics()
+{
+    stopRenderThread();
+}
+
 //===========================================================================//
 bool Graphics::clear()
 {
+    if (mHeadless)
+    {
+        return true;
+    }
+
     sf::Event event;
     while (mWindow.pollEvent(event))
     {
         if (event.type == sf::Event::Closed)
         {
+            stopRenderThread();
             mWindow.close();
             return false;
         }
     }
 
+    // The render thread clears its own buffer
+    if (mPipelined)
+    {
+        return true;
+    }
+
     // clear the window with black color
     mWindow.clear(sf::Color::Black);
     return true;
@@ -66,19 +162,57 @@ bool Graphics::clear()
 //===========================================================================//
 void Graphics::render()
 {
-    // Render all sprites
-    for (auto& sprite : mSprites)
+    // Nothing is left to draw a snapshot once the render thread stopped
+    if (mHeadless || (mPipelined && !mRenderThread.joinable()))
+    {
+        return;
+    }
+
+    updateSprites();
+    buildBatches();
+
+    // Copy into the back snapshot. The render thread never reads this one.
+    if (mPipelined)
     {
-        mWindow.draw(sprite->get());
+        Snapshot& snapshot = mSnapshots[mWriteSnapshot];
+        snapshot.view = mView;
+        snapshot.batches = mBatches;
+        return;
     }
 
+    // Render all sprites
+    mWindow.setView(mView);
+    drawBatches(mBatches);
 }
 
 //===========================================================================//
 void Graphics::present()
 {
-    // end the current frame
-    mWindow.display();
+    // Waiting on a stopped render thread would never return
+    if (mHeadless || (mPipelined && !mRenderThread.joinable()))
+    {
+        return;
+    }
+
+    if (mPipelined)
+    {
+        // Hand the back snapshot over once the last frame is drawn
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCondition.wait(lock, [this]
+        {
+            return !mSnapshotPending && !mRendering;
+        });
+        mReadSnapshot = mWriteSnapshot;
+        mWriteSnapshot = 1 - mWriteSnapshot;
+        mSnapshotPending = true;
+        lock.unlock();
+        mCondition.notify_all();
+    }
+    else
+    {
+        // end the current frame
+        mWindow.display();
+    }
 
     // Check if one second has passed
     ++mFrames;
@@ -91,9 +225,263 @@ void Graphics::present()
 }
 
 //===========================================================================//
-Sprite& Graphics::addSprite(const std::string& pathname)
+void Graphics::reset()
+{
+    // Snapshots point at textures owned by the sprites
+    waitForRenderThread();
+    mSnapshots[0].batches.clear();
+    mSnapshots[1].batches.clear();
+    mSprites.clear();
+    mDrawOrder.clear();
+    mNextDrawOrder = 0;
+    mQuads.clear();
+    mDirtySprites.clear();
+    mVisible.clear();
+    mBatches.clear();
+    mGrid.clear();
+    mTextures.purge();
+}
+
+//===========================================================================//
+size_t Graphics::addSprite(const std::string& pathname)
+{
+    return addSprite(mTextures.get(pathname));
+}
+
+//===========================================================================//
+size_t Graphics::addSprite(const TextureRegion& texture)
+{
+    const size_t index = mSprites.size();
+    mSprites.push_back(Sprite(texture));
+
+    // Indices change when sprites are removed so the order is kept apart
+    mDrawOrder.push_back(mNextDrawOrder++);
+
+    // Nothing is ever drawn when headless so changes are not tracked
+    if (!mHeadless)
+    {
+        mSprites.back().setDirtyList(&mDirtySprites, index);
+        mDirtySprites.push_back(index);
+        mQuads.resize(mQuads.size() + VERTICES_PER_SPRITE);
+    }
+    return index;
+}
+
+//===========================================================================//
+void Graphics::reserveSprites(size_t count)
+{
+    mSprites.reserve(mSprites.size() + count);
+    mDrawOrder.reserve(mDrawOrder.size() + count);
+    if (!mHeadless)
+    {
+        mDirtySprites.reserve(mDirtySprites.size() + count);
+        mQuads.reserve(mQuads.size() + count * VERTICES_PER_SPRITE);
+    }
+}
+
+//===========================================================================//
+void Graphics::removeSprite(size_t index)
+{
+    const size_t last = mSprites.size() - 1;
+    mGrid.remove(index);
+    mGrid.remove(last);
+
+    // Pending changes are dropped and picked up again below if the moved
+    // sprite still needs them
+    mDirtySprites.erase(std::remove_if(mDirtySprites.begin(),
+                                       mDirtySprites.end(),
+                                       [index, last](size_t dirty)
+                                       {
+                                           return dirty == index ||
+                                                  dirty == last;
+                                       }),
+                        mDirtySprites.end());
+
+    if (index != last)
+    {
+        mSprites[index] = std::move(mSprites[last]);
+        mDrawOrder[index] = mDrawOrder[last];
+        if (!mHeadless)
+        {
+            Sprite& sprite = mSprites[index];
+            sprite.setDirtyList(&mDirtySprites, index);
+            sf::Vertex* quad = &mQuads[index * VERTICES_PER_SPRITE];
+            const sf::Vertex* moved = &mQuads[last * VERTICES_PER_SPRITE];
+            std::copy(moved, moved + VERTICES_PER_SPRITE, quad);
+            if (sprite.isDirty())
+            {
+                mDirtySprites.push_back(index);
+            }
+            else if (sprite.isVisible())
+            {
+                mGrid.update(index, getBounds(quad));
+            }
+        }
+    }
+
+    mSprites.pop_back();
+    mDrawOrder.pop_back();
+    if (!mHeadless)
+    {
+        mQuads.resize(mQuads.size() - VERTICES_PER_SPRITE);
+    }
+}
+
+//===========================================================================//
+void Graphics::loadAtlas(const std::string& pathname)
+{
+    mTextures.loadAtlas(pathname);
+}
+
+//===========================================================================//
+void Graphics::updateSprites()
+{
+    // Only sprites that changed since the last frame are visited
+    for (size_t index : mDirtySprites)
+    {
+        const Sprite& sprite = mSprites[index];
+        sf::Vertex* quad = &mQuads[index * VERTICES_PER_SPRITE];
+        writeQuad(sprite.get(), quad);
+        if (sprite.isVisible())
+        {
+            mGrid.update(index, getBounds(quad));
+        }
+        else
+        {
+            mGrid.remove(index);
+        }
+        mSprites[index].setClean();
+    }
+    mDirtySprites.clear();
+}
+
+//===========================================================================//
+void Graphics::buildBatches()
+{
+    // The inverse view transform maps the whole screen into the world
+    const sf::FloatRect area = mView.getInverseTransform().transformRect(
+            sf::FloatRect(-1.0f, -1.0f, 2.0f, 2.0f));
+    mVisible.clear();
+    mGrid.query(area, mVisible);
+
+    // Sorting keeps the order sprites were added in. Only consecutive
+    // sprites that share a texture are merged.
+    const std::vector<uint64_t>& order = mDrawOrder;
+    std::sort(mVisible.begin(),
+              mVisible.end(),
+              [&order](size_t first, size_t second)
+              {
+                  return order[first] < order[second];
+              });
+    size_t used = 0;
+    for (size_t index : mVisible)
+    {
+        const Sprite& sprite = mSprites[index];
+        const sf::Texture* texture = sprite.get().getTexture();
+        if (used == 0 || mBatches[used - 1].texture != texture)
+        {
+            if (used == mBatches.size())
+            {
+                mBatches.push_back(Batch());
+                mBatches.back().vertices.setPrimitiveType(sf::Quads);
+            }
+            mBatches[used].texture = texture;
+            mBatches[used].vertices.clear();
+            ++used;
+        }
+
+        sf::VertexArray& vertices = mBatches[used - 1].vertices;
+        const sf::Vertex* quad = &mQuads[index * VERTICES_PER_SPRITE];
+        for (size_t ii = 0; ii < VERTICES_PER_SPRITE; ++ii)
+        {
+            vertices.append(quad[ii]);
+        }
+    }
+    mBatches.resize(used);
+}
+
+//===========================================================================//
+void Graphics::drawBatches(const std::vector<Batch>& batches)
+{
+    for (const Batch& batch : batches)
+    {
+        mWindow.draw(batch.vertices, sf::RenderStates(batch.texture));
+    }
+}
+
+//===========================================================================//
+void Graphics::renderLoop()
+{
+    mWindow.setActive(true);
+
+    while (true)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCondition.wait(lock, [this]
+        {
+            return mSnapshotPending || mStopRendering;
+        });
+        if (mStopRendering)
+        {
+            break;
+        }
+        const Snapshot& snapshot = mSnapshots[mReadSnapshot];
+        mSnapshotPending = false;
+        mRendering = true;
+        lock.unlock();
+
+        {
+            NYRA_PROFILE("draw");
+            mWindow.clear(sf::Color::Black);
+            mWindow.setView(snapshot.view);
+            drawBatches(snapshot.batches);
+            mWindow.display();
+        }
+
+        lock.lock();
+        mRendering = false;
+        lock.unlock();
+        mCondition.notify_all();
+    }
+
+    mWindow.setActive(false);
+}
+
+//===========================================================================//
+void Graphics::waitForRenderThread()
+{
+    if (!mRenderThread.joinable())
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mCondition.wait(lock, [this]
+    {
+        return !mSnapshotPending && !mRendering;
+    });
+}
+
+//===========================================================================//
+void Graphics::stopRenderThread()
 {
-    mSprites.push_back(std::unique_ptr<Sprite>(new Sprite(pathname)));
-    return *mSprites.back();
+    if (!mRenderThread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopRendering = true;
+    }
+    mCondition.notify_all();
+    mRenderThread.join();
+
+    // A snapshot handed over just before stopping is never drawn
+    mSnapshotPending = false;
+    mRendering = false;
+
+    // Take the context back for anything drawn after this
+    mWindow.setActive(true);
+}
 }
-}
\ No newline at end of file
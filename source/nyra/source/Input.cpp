@@ -29,7 +29,8 @@
 namespace nyra
 {
 //===========================================================================//
-Input::Input() :
+Input::Input(bool headless) :
+    mHeadless(headless),
     mKeysPrev(sf::Keyboard::KeyCount, false)
 {
     Logger::info("Input initialized");
@@ -45,6 +46,11 @@ void Input::registerInput(const std::string& name,
 //===========================================================================//
 void Input::update()
 {
+    if (mHeadless)
+    {
+        return;
+    }
+
     for (size_t ii = 0; ii < mKeysPrev.size(); ++ii)
     {
         mKeysPrev[ii] = sf::Keyboard::isKeyPressed(
@@ -68,6 +74,11 @@ const std::vector<size_t>& Input::getInputs(const std::string& name) const
 bool Input::buttonPressed(const std::string& name) const
 {
     const std::vector<size_t>& inputs = getInputs(name);
+    if (mHeadless)
+    {
+        return false;
+    }
+
     for (size_t ii : inputs)
     {
         const size_t key = ii - Keyboard::KEYBOARD_OFFSET;
@@ -85,6 +96,11 @@ bool Input::buttonPressed(const std::string& name) const
 bool Input::buttonDown(const std::string& name) const
 {
     const std::vector<size_t>& inputs = getInputs(name);
+    if (mHeadless)
+    {
+        return false;
+    }
+
     for (size_t ii : inputs)
     {
         const size_t key = ii - Keyboard::KEYBOARD_OFFSET;
@@ -101,6 +117,11 @@ bool Input::buttonDown(const std::string& name) const
 bool Input::buttonReleased(const std::string& name) const
 {
     const std::vector<size_t>& inputs = getInputs(name);
+    if (mHeadless)
+    {
+        return false;
+    }
+
     for (size_t ii : inputs)
     {
         const size_t key = ii - Keyboard::KEYBOARD_OFFSET;
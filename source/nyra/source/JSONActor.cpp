@@ -34,7 +34,13 @@ JSONActor::JSONActor(const std::string& pathname) :
     script(mReader.hasValue("script") ?
             new JSONScript(mReader.getNode("script")) : nullptr),
     physics(mReader.hasValue("physics") ?
-            new JSONPhysics(mReader.getNode("physics")) : nullptr)
+            new JSONPhysics(mReader.getNode("physics")) : nullptr),
+    children(mReader.hasValue("children") ?
+            mReader.getArray<JSONChild>("children") :
+            std::vector<JSONChild>()),
+    tags(mReader.hasValue("tags") ?
+            mReader.getStringArray("tags") :
+            std::vector<std::string>())
 {
 }
 
@@ -53,7 +59,9 @@ JSONActor::JSONScript::JSONScript(const JSONNode& json) :
     update(json.hasValue("update") ?
             new std::string(json.getString("update")) : nullptr),
     init(json.hasValue("init") ?
-            new std::string(json.getString("init")) : nullptr)
+            new std::string(json.getString("init")) : nullptr),
+    events(json.hasValue("events") ?
+            new std::string(json.getString("events")) : nullptr)
 {
 }
 
@@ -79,4 +87,13 @@ JSONActor::JSONPhysics::JSONPhysicsShape::JSONPhysicsShape(
             json.getDouble("radius") : 0.0)
 {
 }
-}
\ No newline at end of file
+
+//===========================================================================//
+JSONActor::JSONChild::JSONChild(const JSONNode& json) :
+    filename(json.getString("filename")),
+    offset(json.hasValue("offset") ?
+            json.getVector2("offset") : Vector2(0.0, 0.0)),
+    rotation(json.hasValue("rotation") ? json.getDouble("rotation") : 0.0)
+{
+}
+}
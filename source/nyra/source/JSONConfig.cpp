@@ -37,6 +37,15 @@ JSONConfig::JSONConfig(const std::string& pathname) :
     {
         mConfig.framesPerSecond = mReader.getDouble("fps");
     }
+    if (mReader.hasValue("steps per second"))
+    {
+        mConfig.stepsPerSecond = mReader.getDouble("steps per second");
+    }
+    if (mReader.hasValue("max steps per frame"))
+    {
+        mConfig.maxStepsPerFrame = static_cast<size_t>(
+                mReader.getDouble("max steps per frame"));
+    }
     if (mReader.hasValue("title"))
     {
         mConfig.title = mReader.getString("title");
@@ -58,13 +67,62 @@ JSONConfig::JSONConfig(const std::string& pathname) :
     {
         mConfig.vsync = mReader.getBool("vsync");
     }
+    if (mReader.hasValue("headless"))
+    {
+        mConfig.headless = mReader.getBool("headless");
+    }
+    if (mReader.hasValue("pipelined"))
+    {
+        mConfig.pipelined = mReader.getBool("pipelined");
+    }
     if (mReader.hasValue("gravity"))
     {
         mConfig.gravity = mReader.getVector2("gravity");
     }
+    if (mReader.hasValue("velocity iterations"))
+    {
+        mConfig.physics.velocityIterations = static_cast<size_t>(
+                mReader.getDouble("velocity iterations"));
+    }
+    if (mReader.hasValue("position iterations"))
+    {
+        mConfig.physics.positionIterations = static_cast<size_t>(
+                mReader.getDouble("position iterations"));
+    }
+    if (mReader.hasValue("physics sub steps"))
+    {
+        mConfig.physics.subSteps = static_cast<size_t>(
+                mReader.getDouble("physics sub steps"));
+    }
+    if (mReader.hasValue("allow sleeping"))
+    {
+        mConfig.physics.allowSleeping = mReader.getBool("allow sleeping");
+    }
+    if (mReader.hasValue("warm starting"))
+    {
+        mConfig.physics.warmStarting = mReader.getBool("warm starting");
+    }
+    if (mReader.hasValue("continuous physics"))
+    {
+        mConfig.physics.continuousPhysics =
+                mReader.getBool("continuous physics");
+    }
+    if (mReader.hasValue("physics threads"))
+    {
+        mConfig.physicsThreads = static_cast<size_t>(
+                mReader.getDouble("physics threads"));
+    }
+    if (mReader.hasValue("merge static tiles"))
+    {
+        mConfig.mergeStaticTiles = mReader.getBool("merge static tiles");
+    }
     if (mReader.hasValue("default map"))
     {
         mConfig.defaultMap = mReader.getString("default map");
     }
+    if (mReader.hasValue("profile output"))
+    {
+        mConfig.profileOutput = mReader.getString("profile output");
+    }
 }
 }
\ No newline at end of file
@@ -28,7 +28,13 @@ namespace nyra
 //===========================================================================//
 JSONMap::JSONMap(const std::string& pathname) :
     mReader(pathname),
-    actors(mReader.getArray<JSONActorInstance>("actors"))
+    actors(mReader.getArray<JSONActorInstance>("actors")),
+    pools(mReader.hasValue("pools") ?
+            mReader.getArray<JSONPoolInstance>("pools") :
+            std::vector<JSONPoolInstance>()),
+    sectors(mReader.hasValue("sectors") ?
+            mReader.getArray<JSONSector>("sectors") :
+            std::vector<JSONSector>())
 {
 }
 
@@ -39,4 +45,18 @@ JSONMap::JSONActorInstance::JSONActorInstance(const JSONNode& json) :
     rotation(json.hasValue("rotation") ? json.getDouble("rotation") : 0.0)
 {
 }
+
+//===========================================================================//
+JSONMap::JSONSector::JSONSector(const JSONNode& json) :
+    lower(json.getVector2("lower")),
+    upper(json.getVector2("upper"))
+{
+}
+
+//===========================================================================//
+JSONMap::JSONPoolInstance::JSONPoolInstance(const JSONNode& json) :
+    filename(json.getString("filename")),
+    count(static_cast<size_t>(json.getDouble("count")))
+{
+}
 }
\ No newline at end of file
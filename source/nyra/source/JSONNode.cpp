@@ -95,6 +95,35 @@ Vector2 JSONNode::getVector2(const std::string& nodeName,
     return Vector2(node.getDouble(x), node.getDouble(y));
 }
 
+//===========================================================================//
+std::vector<std::string> JSONNode::getStringArray(
+        const std::string& name) const
+{
+    hasValue(name, true);
+    const rapidjson::Value& value = (*mValue)[name.c_str()];
+    std::vector<std::string> ret;
+    if (value.IsString())
+    {
+        ret.push_back(value.GetString());
+        return ret;
+    }
+    else if (value.IsArray())
+    {
+        for (rapidjson::SizeType ii = 0; ii < value.Size(); ++ii)
+        {
+            if (!value[ii].IsString())
+            {
+                throw std::runtime_error(
+                        "Node: " + name + " does not contain strings.");
+            }
+            ret.push_back(value[ii].GetString());
+        }
+        return ret;
+    }
+    throw std::runtime_error(
+            "Node: " + name + " does not contain a vector.");
+}
+
 //===========================================================================//
 bool JSONNode::hasValue(const std::string& name,
                         bool require) const
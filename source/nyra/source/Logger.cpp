@@ -77,7 +77,6 @@ void Logger::log(Level level,
 {
     if (level < mLevel)
     {
-        std::cout << "Failed: " << level << " " << mLevel << " " << message << "\n";
         return;
     }
 
@@ -22,19 +22,65 @@
  * IN THE SOFTWARE.
  */
 #include <nyra/PhysicsBody.h>
+#include <limits>
 
 namespace nyra
 {
+//===========================================================================//
+const size_t PhysicsBody::NOT_AWAKE = std::numeric_limits<size_t>::max();
+
 //===========================================================================//
 PhysicsBody::PhysicsBody(Type type,
-           b2World& world)
+           b2World& world) :
+    mPrevAngle(0.0f),
+    mIndex(0),
+    mAwakeList(nullptr),
+    mAwakeIndex(NOT_AWAKE),
+    mUnplacedList(nullptr),
+    mUnplacedIndex(0),
+    mActor(INVALID_ACTOR),
+    mSector(0),
+    mPlaced(false)
 {
     b2BodyDef bodyDef;
     if (type == DYNAMIC)
     {
         bodyDef.type = b2_dynamicBody;
     }
+    else if (type == KINEMATIC)
+    {
+        bodyDef.type = b2_kinematicBody;
+    }
     mBody = world.CreateBody(&bodyDef);
+    mBody->SetUserData(this);
+    storeTransform();
+}
+
+//===========================================================================//
+void PhysicsBody::wake()
+{
+    if (mBody->GetType() == b2_staticBody)
+    {
+        return;
+    }
+
+    mBody->SetAwake(true);
+    if (mAwakeList && mAwakeIndex == NOT_AWAKE)
+    {
+        mAwakeIndex = mAwakeList->size();
+        mAwakeList->push_back(this);
+    }
+}
+
+//===========================================================================//
+void PhysicsBody::unplace()
+{
+    if (mUnplacedList && mPlaced)
+    {
+        mPlaced = false;
+        mUnplacedIndex = mUnplacedList->size();
+        mUnplacedList->push_back(this);
+    }
 }
 
 //===========================================================================//
@@ -52,6 +98,18 @@ void PhysicsBody::addBox(const Vector2& size,
     mBody->CreateFixture(&fixture);
 }
 
+//===========================================================================//
+void PhysicsBody::addShape(const b2Shape& shape,
+                           float density,
+                           float friction)
+{
+    b2FixtureDef fixture;
+    fixture.density = density;
+    fixture.friction = friction;
+    fixture.shape = &shape;
+    mBody->CreateFixture(&fixture);
+}
+
 //===========================================================================//
 void PhysicsBody::addCircle(float radius,
                             float density,
@@ -65,4 +123,44 @@ void PhysicsBody::addCircle(float radius,
     fixture.shape = &circle;
     mBody->CreateFixture(&fixture);
 }
-}
\ No newline at end of file
+
+//===========================================================================//
+void PhysicsBody::moveTo(b2World& world, size_t sector)
+{
+    b2BodyDef bodyDef;
+    bodyDef.type = mBody->GetType();
+    bodyDef.position = mBody->GetPosition();
+    bodyDef.angle = mBody->GetAngle();
+    bodyDef.linearVelocity = mBody->GetLinearVelocity();
+    bodyDef.angularVelocity = mBody->GetAngularVelocity();
+    bodyDef.linearDamping = mBody->GetLinearDamping();
+    bodyDef.angularDamping = mBody->GetAngularDamping();
+    bodyDef.allowSleep = mBody->IsSleepingAllowed();
+    bodyDef.awake = mBody->IsAwake();
+    bodyDef.fixedRotation = mBody->IsFixedRotation();
+    bodyDef.bullet = mBody->IsBullet();
+    bodyDef.active = mBody->IsActive();
+    bodyDef.gravityScale = mBody->GetGravityScale();
+    bodyDef.userData = this;
+    b2Body* body = world.CreateBody(&bodyDef);
+
+    // Fixtures copy their shape so the old ones can be used directly
+    for (const b2Fixture* fixture = mBody->GetFixtureList();
+         fixture;
+         fixture = fixture->GetNext())
+    {
+        b2FixtureDef fixtureDef;
+        fixtureDef.shape = fixture->GetShape();
+        fixtureDef.density = fixture->GetDensity();
+        fixtureDef.friction = fixture->GetFriction();
+        fixtureDef.restitution = fixture->GetRestitution();
+        fixtureDef.isSensor = fixture->IsSensor();
+        fixtureDef.filter = fixture->GetFilterData();
+        body->CreateFixture(&fixtureDef);
+    }
+
+    mBody->GetWorld()->DestroyBody(mBody);
+    mBody = body;
+    mSector = sector;
+}
+}
@@ -23,48 +23,1091 @@
  */
 #include <nyra/Physics.h>
 #include <nyra/Logger.h>
+#include <nyra/Constants.h>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <string>
 
 namespace
 {
+// Room for contacts so a busy frame does not need to grow the buffer
+static const size_t CONTACT_CAPACITY = 1024;
+
+// Box edges closer than this are treated as touching
+static const float32 MERGE_TOLERANCE = b2_linearSlop;
+
+//===========================================================================//
+void initializeContactTypes()
+{
+    // Box2D fills a global table of contact types the first time any
+    // contact is created and does not guard it. Creating one here makes
+    // sure that happens on this thread before any sector is stepped on a
+    // worker.
+    b2World world(b2Vec2(0.0f, 0.0f));
+    b2CircleShape circle;
+    circle.m_radius = 1.0f;
+    b2BodyDef bodyDef;
+    bodyDef.type = b2_dynamicBody;
+    world.CreateBody(&bodyDef)->CreateFixture(&circle, 1.0f);
+    bodyDef.type = b2_staticBody;
+    world.CreateBody(&bodyDef)->CreateFixture(&circle, 0.0f);
+    world.Step(0.0f, 1, 1);
+}
+
+//===========================================================================//
+struct Box
+{
+    float32 left;
+    float32 top;
+    float32 right;
+    float32 bottom;
+    float32 friction;
+    size_t sector;
+};
+
+//===========================================================================//
+struct Edge
+{
+    size_t start;
+    size_t end;
+    size_t direction;
+};
+
+//===========================================================================//
+size_t findRoot(std::vector<size_t>& parents, size_t index)
+{
+    while (parents[index] != index)
+    {
+        parents[index] = parents[parents[index]];
+        index = parents[index];
+    }
+    return index;
+}
+
+//===========================================================================//
+void snapCoordinates(std::vector<float32>& values)
+{
+    std::sort(values.begin(), values.end());
+    size_t count = 0;
+    for (size_t ii = 0; ii < values.size(); ++ii)
+    {
+        if (count == 0 || values[ii] - values[count - 1] > MERGE_TOLERANCE)
+        {
+            values[count++] = values[ii];
+        }
+    }
+    values.resize(count);
+}
+
+//===========================================================================//
+size_t findCoordinate(const std::vector<float32>& values, float32 value)
+{
+    return std::lower_bound(values.begin(),
+                            values.end(),
+                            value - MERGE_TOLERANCE) - values.begin();
+}
+
+//===========================================================================//
+size_t findNextEdge(const std::vector<Edge>& edges, size_t current)
+{
+    // Cells that only touch at a corner leave two ways out of a vertex.
+    // Turning right keeps following the same cell so loops never cross.
+    const Edge& edge = edges[current];
+    Edge key;
+    key.start = edge.end;
+    auto iter = std::lower_bound(edges.begin(),
+                                 edges.end(),
+                                 key,
+                                 [](const Edge& lhs, const Edge& rhs)
+                                 {
+                                     return lhs.start < rhs.start;
+                                 });
+    const size_t first = iter - edges.begin();
+    for (; iter != edges.end() && iter->start == edge.end; ++iter)
+    {
+        if (iter->direction == (edge.direction + 1) % 4)
+        {
+            return iter - edges.begin();
+        }
+    }
+    return first;
+}
+
+//===========================================================================//
+nyra::ActorHandle getActor(const b2Fixture& fixture)
+{
+    return static_cast<const nyra::PhysicsBody*>(
+            fixture.GetBody()->GetUserData())->getActor();
+}
+
 //===========================================================================//
-static const size_t VELOCITY_ITERATIONS = 8;
-static const size_t POSITION_ITERATIONS = 3;
+b2Vec2 toMeters(const nyra::Vector2& pixels)
+{
+    return (pixels * nyra::Constants::METERS_PER_PIXEL).toThirdParty<b2Vec2>();
+}
+
+//===========================================================================//
+bool containsPoint(const b2AABB& box, const b2Vec2& point)
+{
+    return point.x >= box.lowerBound.x && point.x <= box.upperBound.x &&
+           point.y >= box.lowerBound.y && point.y <= box.upperBound.y;
+}
+
+//===========================================================================//
+class ClosestRayCallback : public b2RayCastCallback
+{
+public:
+    ClosestRayCallback() :
+        fixture(nullptr),
+        fraction(1.0f)
+    {
+    }
+
+    float32 ReportFixture(b2Fixture* reported,
+                          const b2Vec2& reportedPoint,
+                          const b2Vec2& reportedNormal,
+                          float32 reportedFraction)
+    {
+        if (reported->IsSensor())
+        {
+            return -1.0f;
+        }
+
+        // Each sector is cast separately so a hit may already be closer
+        if (fixture && reportedFraction >= fraction)
+        {
+            return fraction;
+        }
+
+        // Clipping the ray to this hit means only closer hits follow
+        fixture = reported;
+        point = reportedPoint;
+        normal = reportedNormal;
+        fraction = reportedFraction;
+        return reportedFraction;
+    }
+
+    const b2Fixture* fixture;
+    b2Vec2 point;
+    b2Vec2 normal;
+    float32 fraction;
+};
+
+//===========================================================================//
+class FixtureQueryCallback : public b2QueryCallback
+{
+public:
+    FixtureQueryCallback(const b2AABB& box,
+                         std::vector<b2Fixture*>& fixtures) :
+        mBox(box),
+        mFixtures(fixtures)
+    {
+    }
+
+    bool ReportFixture(b2Fixture* fixture)
+    {
+        if (fixture->IsSensor())
+        {
+            return true;
+        }
+
+        // The broadphase reports fixtures whose padded bounds overlap
+        const int32 children = fixture->GetShape()->GetChildCount();
+        for (int32 ii = 0; ii < children; ++ii)
+        {
+            if (b2TestOverlap(fixture->GetAABB(ii), mBox))
+            {
+                mFixtures.push_back(fixture);
+                break;
+            }
+        }
+        return true;
+    }
+
+private:
+    const b2AABB& mBox;
+    std::vector<b2Fixture*>& mFixtures;
+};
+
+//===========================================================================//
+size_t addOutlines(const std::vector<Box>& boxes,
+                   const std::vector<size_t>& cluster,
+                   nyra::PhysicsBody& body)
+{
+    // Only the sides of the boxes matter so the area they cover is split
+    // into a grid of cells between them
+    std::vector<float32> xs;
+    std::vector<float32> ys;
+    for (size_t box : cluster)
+    {
+        xs.push_back(boxes[box].left);
+        xs.push_back(boxes[box].right);
+        ys.push_back(boxes[box].top);
+        ys.push_back(boxes[box].bottom);
+    }
+    snapCoordinates(xs);
+    snapCoordinates(ys);
+    if (xs.size() < 2 || ys.size() < 2)
+    {
+        return 0;
+    }
+
+    const int64_t columns = xs.size() - 1;
+    const int64_t rows = ys.size() - 1;
+    std::vector<bool> covered(columns * rows, false);
+    for (size_t box : cluster)
+    {
+        const int64_t left = findCoordinate(xs, boxes[box].left);
+        const int64_t right = findCoordinate(xs, boxes[box].right);
+        const int64_t top = findCoordinate(ys, boxes[box].top);
+        const int64_t bottom = findCoordinate(ys, boxes[box].bottom);
+        for (int64_t y = top; y < bottom; ++y)
+        {
+            for (int64_t x = left; x < right; ++x)
+            {
+                covered[y * columns + x] = true;
+            }
+        }
+    }
+
+    auto isCovered = [&](int64_t x, int64_t y)
+    {
+        return x >= 0 && y >= 0 && x < columns && y < rows &&
+               covered[y * columns + x];
+    };
+    auto vertex = [&](int64_t x, int64_t y)
+    {
+        return static_cast<size_t>(y * (columns + 1) + x);
+    };
+
+    // Every side of a covered cell that faces an empty cell is part of an
+    // outline. Sides are directed clockwise around their cell so each
+    // outline can be followed from vertex to vertex.
+    std::vector<Edge> edges;
+    for (int64_t y = 0; y < rows; ++y)
+    {
+        for (int64_t x = 0; x < columns; ++x)
+        {
+            if (!isCovered(x, y))
+            {
+                continue;
+            }
+            if (!isCovered(x, y - 1))
+            {
+                edges.push_back({vertex(x, y), vertex(x + 1, y), 0});
+            }
+            if (!isCovered(x + 1, y))
+            {
+                edges.push_back({vertex(x + 1, y), vertex(x + 1, y + 1), 1});
+            }
+            if (!isCovered(x, y + 1))
+            {
+                edges.push_back({vertex(x + 1, y + 1), vertex(x, y + 1), 2});
+            }
+            if (!isCovered(x - 1, y))
+            {
+                edges.push_back({vertex(x, y + 1), vertex(x, y), 3});
+            }
+        }
+    }
+    std::sort(edges.begin(),
+              edges.end(),
+              [](const Edge& lhs, const Edge& rhs)
+              {
+                  return lhs.start < rhs.start;
+              });
+
+    const float32 friction = boxes[cluster.front()].friction;
+    std::vector<bool> used(edges.size(), false);
+    std::vector<size_t> loop;
+    std::vector<b2Vec2> vertices;
+    size_t loops = 0;
+    for (size_t first = 0; first < edges.size(); ++first)
+    {
+        if (used[first])
+        {
+            continue;
+        }
+
+        loop.clear();
+        size_t current = first;
+        do
+        {
+            used[current] = true;
+            loop.push_back(current);
+            current = findNextEdge(edges, current);
+        }
+        while (current != first);
+
+        // Only corners are kept. Straight runs of cell sides become
+        // one edge of the chain.
+        vertices.clear();
+        for (size_t ii = 0; ii < loop.size(); ++ii)
+        {
+            const Edge& edge = edges[loop[ii]];
+            const Edge& previous =
+                    edges[loop[(ii + loop.size() - 1) % loop.size()]];
+            if (edge.direction != previous.direction)
+            {
+                vertices.push_back(b2Vec2(xs[edge.start % (columns + 1)],
+                                          ys[edge.start / (columns + 1)]));
+            }
+        }
+
+        b2ChainShape chain;
+        chain.CreateLoop(vertices.data(), vertices.size());
+        body.addShape(chain, 0.0f, friction);
+        ++loops;
+    }
+    return loops;
+}
 }
 
 namespace nyra
 {
+//===========================================================================//
+Physics::Sector::Sector(const b2Vec2& gravity) :
+    contacts(CONTACT_CAPACITY),
+    world(gravity)
+{
+    world.SetContactListener(&contacts);
+}
+
 //===========================================================================//
 Physics::Physics(const Vector2& gravity,
-                 PhysicsRenderer& renderer) :
-    mWorld((gravity).toThirdParty<b2Vec2>())
+                 const PhysicsSettings& settings,
+                 size_t threads,
+                 PhysicsRenderer& renderer,
+                 Arena& arena) :
+    mGravity((gravity).toThirdParty<b2Vec2>()),
+    mRenderer(renderer),
+    mWorkers(threads),
+    mBodyPool(arena)
+{
+    Logger::info("Physics initialized with " + std::to_string(threads) +
+                 " worker threads");
+    initializeContactTypes();
+    setSettings(settings);
+    addSector();
+    mContacts.reserve(CONTACT_CAPACITY);
+}
+
+//===========================================================================//
+void Physics::setSettings(const PhysicsSettings& settings)
 {
-    Logger::info("Physics initialized");
-    mWorld.SetDebugDraw(&renderer);
+    if (settings.subSteps == 0)
+    {
+        throw std::runtime_error("Physics must take at least one sub step.");
+    }
+
+    mSettings = settings;
+    for (auto& sector : mSectors)
+    {
+        sector->world.SetAllowSleeping(mSettings.allowSleeping);
+        sector->world.SetWarmStarting(mSettings.warmStarting);
+        sector->world.SetContinuousPhysics(mSettings.continuousPhysics);
+    }
+}
+
+//===========================================================================//
+void Physics::setSectors(const std::vector<Vector2>& corners)
+{
+    if (!mBodies.empty())
+    {
+        throw std::runtime_error(
+                "Sectors must be set before any bodies are added.");
+    }
+    if (corners.size() % 2 != 0)
+    {
+        throw std::runtime_error("Sectors must be pairs of corners.");
+    }
+
+    mSectors.resize(1);
+    for (size_t ii = 0; ii < corners.size(); ii += 2)
+    {
+        addSector();
+        mSectors.back()->bounds.lowerBound = toMeters(corners[ii]);
+        mSectors.back()->bounds.upperBound = toMeters(corners[ii + 1]);
+    }
 }
 
 //===========================================================================//
 void Physics::update(double deltaTime)
 {
-    mWorld.Step(deltaTime,
-                VELOCITY_ITERATIONS,
-                POSITION_ITERATIONS);
+    placeBodies();
+
+    // Sleeping bodies are skipped by the step so only awake bodies need
+    // their transform kept
+    for (PhysicsBody* body : mAwake)
+    {
+        body->storeTransform();
+    }
+
+    // Sectors have their own world and listener so each is stepped on its
+    // own thread. Box2D's table of contact types is shared but was filled
+    // on this thread when physics was created. Its global GJK and TOI
+    // counters are still updated by every thread without a guard, so
+    // their values are meaningless while sectors run in parallel. Nothing
+    // here reads them. Each sub step adds its cost to the stats of the
+    // sector.
+    const float32 subStep = deltaTime / mSettings.subSteps;
+    mWorkers.run(mSectors.size(), [this, subStep](size_t index)
+    {
+        Sector& sector = *mSectors[index];
+        sector.stats = PhysicsStats();
+        for (size_t ii = 0; ii < mSettings.subSteps; ++ii)
+        {
+            sector.contacts.beginStep();
+            sector.world.Step(subStep,
+                              mSettings.velocityIterations,
+                              mSettings.positionIterations);
+
+            const b2Profile& profile = sector.world.GetProfile();
+            sector.stats.step += profile.step;
+            sector.stats.collide += profile.collide;
+            sector.stats.solve += profile.solve;
+            sector.stats.solveInit += profile.solveInit;
+            sector.stats.solveVelocity += profile.solveVelocity;
+            sector.stats.solvePosition += profile.solvePosition;
+            sector.stats.broadphase += profile.broadphase;
+            sector.stats.solveTOI += profile.solveTOI;
+        }
+    });
+
+    // Times are summed so they are the total work rather than how long
+    // the update took
+    mStats = PhysicsStats();
+    for (auto& sector : mSectors)
+    {
+        mStats.step += sector->stats.step;
+        mStats.collide += sector->stats.collide;
+        mStats.solve += sector->stats.solve;
+        mStats.solveInit += sector->stats.solveInit;
+        mStats.solveVelocity += sector->stats.solveVelocity;
+        mStats.solvePosition += sector->stats.solvePosition;
+        mStats.broadphase += sector->stats.broadphase;
+        mStats.solveTOI += sector->stats.solveTOI;
+        mStats.bodies += sector->world.GetBodyCount();
+        mStats.contacts += sector->world.GetContactCount();
+        mStats.proxies += sector->world.GetProxyCount();
+
+        const std::vector<Contact>& contacts = sector->contacts.getContacts();
+        mContacts.insert(mContacts.end(), contacts.begin(), contacts.end());
+        sector->contacts.clear();
+    }
+
+    // Box2D wakes bodies that touch an awake body. Walk the contacts of
+    // the awake list to find them. The list can grow while walking.
+    for (size_t ii = 0; ii < mAwake.size(); ++ii)
+    {
+        for (b2ContactEdge* edge = mAwake[ii]->get().GetContactList();
+             edge;
+             edge = edge->next)
+        {
+            if (edge->other->IsAwake() && edge->contact->IsTouching())
+            {
+                static_cast<PhysicsBody*>(edge->other->GetUserData())->wake();
+            }
+        }
+    }
+
+    // Every awake body is in the awake list so only it needs counting
+    for (const PhysicsBody* body : mAwake)
+    {
+        if (body->get().IsAwake())
+        {
+            ++mStats.awakeBodies;
+        }
+    }
+}
+
+//===========================================================================//
+void Physics::render()
+{
+    for (auto& sector : mSectors)
+    {
+        sector->world.DrawDebugData();
+    }
+}
+
+//===========================================================================//
+bool Physics::canMerge(const PhysicsBody& body)
+{
+    const b2Body& native = body.get();
+    if (native.GetType() != b2_staticBody ||
+        native.GetAngle() != 0.0f ||
+        !native.GetFixtureList())
+    {
+        return false;
+    }
+
+    for (const b2Fixture* fixture = native.GetFixtureList();
+         fixture;
+         fixture = fixture->GetNext())
+    {
+        if (fixture->IsSensor() || fixture->GetType() != b2Shape::e_polygon)
+        {
+            return false;
+        }
+
+        const b2PolygonShape& shape =
+                static_cast<const b2PolygonShape&>(*fixture->GetShape());
+        if (shape.m_count != 4)
+        {
+            return false;
+        }
+
+        // A box has every corner on both an x and a y extent
+        b2Vec2 lower = shape.m_vertices[0];
+        b2Vec2 upper = shape.m_vertices[0];
+        for (int32 ii = 1; ii < shape.m_count; ++ii)
+        {
+            lower.x = std::min(lower.x, shape.m_vertices[ii].x);
+            lower.y = std::min(lower.y, shape.m_vertices[ii].y);
+            upper.x = std::max(upper.x, shape.m_vertices[ii].x);
+            upper.y = std::max(upper.y, shape.m_vertices[ii].y);
+        }
+        for (int32 ii = 0; ii < shape.m_count; ++ii)
+        {
+            const b2Vec2& corner = shape.m_vertices[ii];
+            if ((corner.x != lower.x && corner.x != upper.x) ||
+                (corner.y != lower.y && corner.y != upper.y))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//===========================================================================//
+void Physics::mergeStaticBoxes(const std::vector<PhysicsBody*>& bodies)
+{
+    std::vector<Box> boxes;
+    for (PhysicsBody* body : bodies)
+    {
+        const b2Vec2& position = body->get().GetPosition();
+        for (const b2Fixture* fixture = body->get().GetFixtureList();
+             fixture;
+             fixture = fixture->GetNext())
+        {
+            const b2PolygonShape& shape =
+                    static_cast<const b2PolygonShape&>(*fixture->GetShape());
+            Box box;
+            box.left = std::numeric_limits<float32>::max();
+            box.top = std::numeric_limits<float32>::max();
+            box.right = -std::numeric_limits<float32>::max();
+            box.bottom = -std::numeric_limits<float32>::max();
+            box.friction = fixture->GetFriction();
+            for (int32 ii = 0; ii < shape.m_count; ++ii)
+            {
+                const float32 x = position.x + shape.m_vertices[ii].x;
+                const float32 y = position.y + shape.m_vertices[ii].y;
+                box.left = std::min(box.left, x);
+                box.top = std::min(box.top, y);
+                box.right = std::max(box.right, x);
+                box.bottom = std::max(box.bottom, y);
+            }
+            box.sector = findSector(b2Vec2((box.left + box.right) * 0.5f,
+                                           (box.top + box.bottom) * 0.5f));
+            boxes.push_back(box);
+        }
+        removeBody(*body);
+    }
+
+    if (boxes.empty())
+    {
+        return;
+    }
+
+    // Join boxes in the same sector that touch. Sorting by the left side
+    // means each box only needs to be compared with those that start
+    // before it ends.
+    std::sort(boxes.begin(),
+              boxes.end(),
+              [](const Box& lhs, const Box& rhs)
+              {
+                  return lhs.sector < rhs.sector ||
+                         (lhs.sector == rhs.sector && lhs.left < rhs.left);
+              });
+    std::vector<size_t> parents(boxes.size());
+    for (size_t ii = 0; ii < boxes.size(); ++ii)
+    {
+        parents[ii] = ii;
+    }
+    for (size_t ii = 0; ii < boxes.size(); ++ii)
+    {
+        const Box& box = boxes[ii];
+        for (size_t jj = ii + 1;
+             jj < boxes.size() &&
+                     boxes[jj].sector == box.sector &&
+                     boxes[jj].left <= box.right + MERGE_TOLERANCE;
+             ++jj)
+        {
+            const Box& other = boxes[jj];
+            if (other.friction == box.friction &&
+                other.top <= box.bottom + MERGE_TOLERANCE &&
+                box.top <= other.bottom + MERGE_TOLERANCE)
+            {
+                parents[findRoot(parents, jj)] = findRoot(parents, ii);
+            }
+        }
+    }
+
+    // Group the boxes of each cluster together
+    std::vector<size_t> order(boxes.size());
+    for (size_t ii = 0; ii < boxes.size(); ++ii)
+    {
+        order[ii] = ii;
+        parents[ii] = findRoot(parents, ii);
+    }
+    std::sort(order.begin(),
+              order.end(),
+              [&parents](size_t lhs, size_t rhs)
+              {
+                  return parents[lhs] < parents[rhs];
+              });
+
+    // Each sector gets its own body for the outlines inside it
+    std::vector<PhysicsBody*> merged(mSectors.size(), nullptr);
+    std::vector<size_t> cluster;
+    size_t loops = 0;
+    for (size_t ii = 0; ii < order.size(); ++ii)
+    {
+        cluster.push_back(order[ii]);
+        if (ii + 1 == order.size() ||
+            parents[order[ii + 1]] != parents[order[ii]])
+        {
+            const size_t sector = boxes[cluster.front()].sector;
+            if (!merged[sector])
+            {
+                merged[sector] = &createBody(PhysicsBody::STATIC, sector);
+            }
+            loops += addOutlines(boxes, cluster, *merged[sector]);
+            cluster.clear();
+        }
+    }
+
+    Logger::info("Merged " + std::to_string(boxes.size()) +
+                 " static boxes into " + std::to_string(loops) +
+                 " chain loops");
+}
+
+//===========================================================================//
+bool Physics::rayCast(const Vector2& start,
+                      const Vector2& end,
+                      RayHit& hit) const
+{
+    const b2Vec2 p1 = toMeters(start);
+    const b2Vec2 p2 = toMeters(end);
+    hit.hit = false;
+
+    // Box2D asserts on rays without length
+    if (p1 == p2)
+    {
+        return false;
+    }
+
+    ClosestRayCallback callback;
+    for (auto& sector : mSectors)
+    {
+        sector->world.RayCast(&callback, p1, p2);
+    }
+    if (!callback.fixture)
+    {
+        return false;
+    }
+
+    hit.hit = true;
+    hit.actor = getActor(*callback.fixture);
+    hit.point = Vector2(callback.point) * Constants::PIXELS_PER_METER;
+    hit.normal = Vector2(callback.normal);
+    hit.fraction = callback.fraction;
+    return true;
+}
+
+//===========================================================================//
+void Physics::rayCast(const std::vector<Vector2>& points,
+                      std::vector<RayHit>& hits) const
+{
+    if (points.size() % 2 != 0)
+    {
+        throw std::runtime_error("Rays must be pairs of start and end points.");
+    }
+
+    hits.resize(points.size() / 2);
+    for (size_t ii = 0; ii < hits.size(); ++ii)
+    {
+        rayCast(points[ii * 2], points[ii * 2 + 1], hits[ii]);
+    }
+}
+
+//===========================================================================//
+bool Physics::circleCast(const Vector2& start,
+                         const Vector2& end,
+                         double radius,
+                         RayHit& hit) const
+{
+    std::vector<b2Fixture*> candidates;
+    return circleCast(toMeters(start),
+                      toMeters(end),
+                      radius * Constants::METERS_PER_PIXEL,
+                      candidates,
+                      hit);
+}
+
+//===========================================================================//
+void Physics::circleCast(const std::vector<Vector2>& points,
+                         const std::vector<double>& radii,
+                         std::vector<RayHit>& hits) const
+{
+    if (points.size() % 2 != 0)
+    {
+        throw std::runtime_error(
+                "Casts must be pairs of start and end points.");
+    }
+    if (radii.size() != points.size() / 2)
+    {
+        throw std::runtime_error("Each cast must have a radius.");
+    }
+
+    // The candidate list is shared so the batch only allocates once
+    std::vector<b2Fixture*> candidates;
+    hits.resize(radii.size());
+    for (size_t ii = 0; ii < hits.size(); ++ii)
+    {
+        circleCast(toMeters(points[ii * 2]),
+                   toMeters(points[ii * 2 + 1]),
+                   radii[ii] * Constants::METERS_PER_PIXEL,
+                   candidates,
+                   hits[ii]);
+    }
+}
+
+//===========================================================================//
+bool Physics::circleCast(const b2Vec2& start,
+                         const b2Vec2& end,
+                         float32 radius,
+                         std::vector<b2Fixture*>& candidates,
+                         RayHit& hit) const
+{
+    hit.hit = false;
+
+    // Only fixtures inside the bounds of the whole path can be touched
+    b2AABB bounds;
+    bounds.lowerBound.Set(std::min(start.x, end.x) - radius,
+                          std::min(start.y, end.y) - radius);
+    bounds.upperBound.Set(std::max(start.x, end.x) + radius,
+                          std::max(start.y, end.y) + radius);
+    candidates.clear();
+    FixtureQueryCallback callback(bounds, candidates);
+    for (auto& sector : mSectors)
+    {
+        sector->world.QueryAABB(&callback, bounds);
+    }
+    if (candidates.empty())
+    {
+        return false;
+    }
+
+    b2CircleShape circle;
+    circle.m_p.SetZero();
+    circle.m_radius = radius;
+
+    b2TOIInput input;
+    input.proxyA.Set(&circle, 0);
+    input.sweepA.localCenter.SetZero();
+    input.sweepA.c0 = start;
+    input.sweepA.c = end;
+    input.sweepA.a0 = 0.0f;
+    input.sweepA.a = 0.0f;
+    input.sweepA.alpha0 = 0.0f;
+
+    // Bodies are treated as still for the length of the cast. Each time
+    // of impact found shortens the cast for the fixtures after it.
+    const b2Fixture* closest = nullptr;
+    int32 closestChild = 0;
+    float32 closestTime = 1.0f;
+    for (const b2Fixture* fixture : candidates)
+    {
+        const b2Body& body = *fixture->GetBody();
+        input.sweepB.localCenter = body.GetLocalCenter();
+        input.sweepB.c0 = body.GetWorldCenter();
+        input.sweepB.c = body.GetWorldCenter();
+        input.sweepB.a0 = body.GetAngle();
+        input.sweepB.a = body.GetAngle();
+        input.sweepB.alpha0 = 0.0f;
+        input.tMax = closestTime;
+
+        const int32 children = fixture->GetShape()->GetChildCount();
+        for (int32 ii = 0; ii < children; ++ii)
+        {
+            input.proxyB.Set(fixture->GetShape(), ii);
+            b2TOIOutput output;
+            b2TimeOfImpact(&output, &input);
+            if ((output.state == b2TOIOutput::e_touching ||
+                 output.state == b2TOIOutput::e_overlapped) &&
+                (!closest || output.t < closestTime))
+            {
+                closest = fixture;
+                closestChild = ii;
+                closestTime = output.t;
+                input.tMax = closestTime;
+            }
+        }
+    }
+
+    if (!closest)
+    {
+        return false;
+    }
+
+    // Find where the circle rests against the fixture at that time
+    const b2Vec2 center = start + closestTime * (end - start);
+    b2DistanceInput distanceInput;
+    distanceInput.proxyA.Set(&circle, 0);
+    distanceInput.proxyB.Set(closest->GetShape(), closestChild);
+    distanceInput.transformA.Set(center, 0.0f);
+    distanceInput.transformB = closest->GetBody()->GetTransform();
+    distanceInput.useRadii = true;
+    b2SimplexCache cache;
+    cache.count = 0;
+    b2DistanceOutput distance;
+    b2Distance(&distance, &cache, &distanceInput);
+
+    // A circle that starts inside has no surface between the two
+    b2Vec2 normal = center - distance.pointB;
+    if (normal.Normalize() == 0.0f)
+    {
+        normal = start - end;
+        normal.Normalize();
+    }
+
+    hit.hit = true;
+    hit.actor = getActor(*closest);
+    hit.point = Vector2(distance.pointB) * Constants::PIXELS_PER_METER;
+    hit.normal = Vector2(normal);
+    hit.fraction = closestTime;
+    return true;
+}
+
+//===========================================================================//
+void Physics::queryBox(const Vector2& lower,
+                       const Vector2& upper,
+                       std::vector<ActorHandle>& actors) const
+{
+    std::vector<b2Fixture*> fixtures;
+    b2AABB box;
+    box.lowerBound = toMeters(lower);
+    box.upperBound = toMeters(upper);
+    FixtureQueryCallback callback(box, fixtures);
+    for (auto& sector : mSectors)
+    {
+        sector->world.QueryAABB(&callback, box);
+    }
+
+    // Bodies with many fixtures are reported once for each
+    const size_t start = actors.size();
+    for (const b2Fixture* fixture : fixtures)
+    {
+        const ActorHandle actor = getActor(*fixture);
+        if (actor != INVALID_ACTOR)
+        {
+            actors.push_back(actor);
+        }
+    }
+    std::sort(actors.begin() + start, actors.end());
+    actors.erase(std::unique(actors.begin() + start, actors.end()),
+                 actors.end());
+}
+
+//===========================================================================//
+void Physics::queryBox(const std::vector<Vector2>& corners,
+                       std::vector<ActorHandle>& actors,
+                       std::vector<size_t>& offsets) const
+{
+    if (corners.size() % 2 != 0)
+    {
+        throw std::runtime_error("Boxes must be pairs of corners.");
+    }
+
+    offsets.resize(corners.size() / 2 + 1);
+    for (size_t ii = 0; ii < corners.size() / 2; ++ii)
+    {
+        offsets[ii] = actors.size();
+        queryBox(corners[ii * 2], corners[ii * 2 + 1], actors);
+    }
+    offsets.back() = actors.size();
+}
+
+//===========================================================================//
+void Physics::pruneAwakeBodies()
+{
+    size_t ii = 0;
+    while (ii < mAwake.size())
+    {
+        const PhysicsBody& body = *mAwake[ii];
+        if (!body.get().IsActive() ||
+            (!body.get().IsAwake() && body.isSettled()))
+        {
+            removeAwake(*mAwake[ii]);
+        }
+        else
+        {
+            ++ii;
+        }
+    }
 }
 
 //===========================================================================//
 void Physics::reset()
 {
-    for (auto& body : mBodies)
+    // Bodies need nothing else cleaned up so their memory is given back
+    // when the arena is reset
+    for (PhysicsBody* body : mBodies)
     {
-        mWorld.DestroyBody(&body->get());
+        body->get().GetWorld()->DestroyBody(&body->get());
     }
     mBodies.clear();
+    mAwake.clear();
+    mUnplaced.clear();
+    mBodyPool.reset();
+
+    // The next map sets its own sectors
+    mSectors.resize(1);
+    mSectors.front()->contacts.clear();
+    mContacts.clear();
 }
 
 //===========================================================================//
 PhysicsBody& Physics::addBody(PhysicsBody::Type type)
 {
-    PhysicsBody* body = new PhysicsBody(type, mWorld);
-    mBodies.push_back(std::unique_ptr<PhysicsBody>(body));
+    // The body is positioned after it is added, so which sector it
+    // belongs to is not known until the next update
+    PhysicsBody& body = createBody(type, 0);
+    body.unplace();
+    return body;
+}
+
+//===========================================================================//
+PhysicsBody& Physics::createBody(PhysicsBody::Type type, size_t sector)
+{
+    PhysicsBody* body = mBodyPool.create(type, mSectors.front()->world);
+    if (sector != 0)
+    {
+        body->moveTo(mSectors[sector]->world, sector);
+    }
+    body->setPlaced(true);
+    body->setIndex(mBodies.size());
+    body->setAwakeList(&mAwake);
+    body->setUnplacedList(&mUnplaced);
+    body->wake();
+    mBodies.push_back(body);
     return *body;
 }
-}
\ No newline at end of file
+
+//===========================================================================//
+void Physics::removeBody(PhysicsBody& body)
+{
+    const size_t index = body.getIndex();
+    if (body.getAwakeIndex() != PhysicsBody::NOT_AWAKE)
+    {
+        removeAwake(body);
+    }
+    if (!body.isPlaced())
+    {
+        // Swap with the last body to keep the list dense
+        const size_t unplacedIndex = body.getUnplacedIndex();
+        mUnplaced[unplacedIndex] = mUnplaced.back();
+        mUnplaced[unplacedIndex]->setUnplacedIndex(unplacedIndex);
+        mUnplaced.pop_back();
+    }
+    body.get().GetWorld()->DestroyBody(&body.get());
+
+    // Swap with the last body to keep the list dense
+    mBodies[index] = mBodies.back();
+    mBodies[index]->setIndex(index);
+    mBodies.pop_back();
+    mBodyPool.destroy(&body);
+}
+
+//===========================================================================//
+void Physics::addSector()
+{
+    mSectors.push_back(std::unique_ptr<Sector>(new Sector(mGravity)));
+    b2World& world = mSectors.back()->world;
+    world.SetDebugDraw(&mRenderer);
+    world.SetAllowSleeping(mSettings.allowSleeping);
+    world.SetWarmStarting(mSettings.warmStarting);
+    world.SetContinuousPhysics(mSettings.continuousPhysics);
+}
+
+//===========================================================================//
+size_t Physics::findSector(const b2Vec2& position) const
+{
+    for (size_t ii = 1; ii < mSectors.size(); ++ii)
+    {
+        if (containsPoint(mSectors[ii]->bounds, position))
+        {
+            return ii;
+        }
+    }
+    return 0;
+}
+
+//===========================================================================//
+void Physics::placeBodies()
+{
+    // With one sector every body is already in the only world
+    const bool hasSectors = mSectors.size() > 1;
+
+    // Bodies that were added or moved from outside of the step
+    for (PhysicsBody* body : mUnplaced)
+    {
+        if (hasSectors)
+        {
+            placeBody(*body);
+        }
+        body->setPlaced(true);
+    }
+    mUnplaced.clear();
+
+    // Only bodies that can have moved need to be checked again
+    if (hasSectors)
+    {
+        for (PhysicsBody* body : mAwake)
+        {
+            placeBody(*body);
+        }
+    }
+}
+
+//===========================================================================//
+void Physics::placeBody(PhysicsBody& body)
+{
+    const size_t current = body.getSector();
+    const b2Vec2& position = body.get().GetPosition();
+    if (current != 0 && containsPoint(mSectors[current]->bounds, position))
+    {
+        return;
+    }
+
+    const size_t sector = findSector(position);
+    if (sector != current)
+    {
+        body.moveTo(mSectors[sector]->world, sector);
+    }
+}
+
+//===========================================================================//
+void Physics::removeAwake(PhysicsBody& body)
+{
+    // Swap with the last body to keep the list dense
+    const size_t index = body.getAwakeIndex();
+    mAwake[index] = mAwake.back();
+    mAwake[index]->setAwakeIndex(index);
+    mAwake.pop_back();
+    body.setAwakeIndex(PhysicsBody::NOT_AWAKE);
+}
+}
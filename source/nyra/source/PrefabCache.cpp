@@ -0,0 +1,201 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#include <nyra/PrefabCache.h>
+#include <nyra/JSONActor.h>
+#include <nyra/Constants.h>
+#include <nyra/Logger.h>
+#include <stdexcept>
+#include <algorithm>
+
+namespace nyra
+{
+//===========================================================================//
+PrefabCache::PrefabCache(const std::string& dataDir,
+                         Graphics& graphics,
+                         ComponentStore& components) :
+    mDataDir(dataDir),
+    mGraphics(graphics),
+    mComponents(components)
+{
+}
+
+//===========================================================================//
+const Prefab& PrefabCache::get(const std::string& filename)
+{
+    auto iter = mPrefabs.find(filename);
+    if (iter == mPrefabs.end())
+    {
+        // A file that is still being loaded further up means its children
+        // lead back to it and spawning it would never finish
+        if (std::find(mLoading.begin(), mLoading.end(), filename) !=
+                mLoading.end())
+        {
+            std::string chain;
+            for (const std::string& loading : mLoading)
+            {
+                chain += loading + " -> ";
+            }
+            throw std::runtime_error(
+                    "Actor file lists itself as a child: " + chain + filename);
+        }
+
+        mLoading.push_back(filename);
+        std::unique_ptr<const Prefab> prefab;
+        try
+        {
+            prefab = load(filename);
+        }
+        catch (...)
+        {
+            mLoading.pop_back();
+            throw;
+        }
+        mLoading.pop_back();
+        iter = mPrefabs.insert(std::make_pair(filename,
+                                              std::move(prefab))).first;
+    }
+    return *iter->second;
+}
+
+//===========================================================================//
+void PrefabCache::clear()
+{
+    mPrefabs.clear();
+}
+
+//===========================================================================//
+std::unique_ptr<const Prefab> PrefabCache::load(const std::string& filename)
+{
+    const std::string pathname(mDataDir + "/actors/" + filename + ".json");
+    Logger::debug("Loading prefab: " + pathname);
+    const JSONActor json(pathname);
+    std::unique_ptr<Prefab> prefab(new Prefab());
+    prefab->tags = 0;
+    for (const std::string& tag : json.tags)
+    {
+        prefab->tags |= mComponents.getTagMask(tag);
+    }
+
+    if (json.sprite.get())
+    {
+        std::unique_ptr<Prefab::SpritePrefab> sprite(
+                new Prefab::SpritePrefab());
+        sprite->texture = mGraphics.getTexture(
+                mDataDir + "/textures/" + json.sprite->filename + ".png");
+        if (json.sprite->origin.get())
+        {
+            sprite->origin = json.sprite->origin->toThirdParty<sf::Vector2f>();
+        }
+        else
+        {
+            sprite->origin = sf::Vector2f(sprite->texture.rect.width / 2.0f,
+                                          sprite->texture.rect.height / 2.0f);
+        }
+        prefab->sprite.reset(sprite.release());
+    }
+
+    if (json.script.get())
+    {
+        std::unique_ptr<Prefab::ScriptPrefab> script(
+                new Prefab::ScriptPrefab());
+        script->module = json.script->module;
+        script->className = json.script->className;
+        if (json.script->update.get())
+        {
+            script->methods.push_back(
+                    std::make_pair("update", *json.script->update));
+        }
+        if (json.script->init.get())
+        {
+            script->methods.push_back(
+                    std::make_pair("init", *json.script->init));
+        }
+        if (json.script->events.get())
+        {
+            script->methods.push_back(
+                    std::make_pair("events", *json.script->events));
+        }
+        prefab->script.reset(script.release());
+    }
+
+    if (json.physics.get())
+    {
+        std::unique_ptr<Prefab::PhysicsPrefab> physics(
+                new Prefab::PhysicsPrefab());
+        if (json.physics->type == "dynamic")
+        {
+            physics->type = PhysicsBody::DYNAMIC;
+        }
+        else if (json.physics->type == "static")
+        {
+            physics->type = PhysicsBody::STATIC;
+        }
+        else if (json.physics->type == "kinematic")
+        {
+            physics->type = PhysicsBody::KINEMATIC;
+        }
+        else
+        {
+            throw std::runtime_error(
+                    "Invalid physics type: " + json.physics->type);
+        }
+
+        for (const auto& jsonShape : json.physics->shapes)
+        {
+            Prefab::ShapePrefab shape;
+            shape.density = jsonShape.density;
+            shape.friction = jsonShape.friction;
+            if (jsonShape.type == "box")
+            {
+                b2PolygonShape* box = new b2PolygonShape();
+                box->SetAsBox(
+                        (jsonShape.size.x * Constants::METERS_PER_PIXEL) / 2.0,
+                        (jsonShape.size.y * Constants::METERS_PER_PIXEL) / 2.0);
+                shape.shape.reset(box);
+            }
+            else
+            {
+                throw std::runtime_error(
+                        "Invalid physics shape: " + jsonShape.type);
+            }
+            physics->shapes.push_back(shape);
+        }
+        prefab->physics.reset(physics.release());
+    }
+
+    for (const auto& jsonChild : json.children)
+    {
+        Prefab::ChildPrefab child;
+        child.filename = jsonChild.filename;
+        child.offset = jsonChild.offset;
+        child.rotation = jsonChild.rotation;
+        prefab->children.push_back(child);
+
+        // Children are parsed now so cycles are caught before any spawning
+        get(child.filename);
+    }
+
+    return std::unique_ptr<const Prefab>(prefab.release());
+}
+}
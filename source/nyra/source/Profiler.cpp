@@ -0,0 +1,239 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#include <nyra/Profiler.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+#include <atomic>
+
+namespace
+{
+//===========================================================================//
+static const size_t EVENTS_PER_THREAD = 65536;
+
+//===========================================================================//
+// Profilers are told apart by id rather than address, since a new profiler
+// can be created where a destroyed one was. Zero is never handed out.
+std::atomic<uint64_t> nextProfilerId(1);
+
+//===========================================================================//
+nyra::Profiler fallbackProfiler;
+
+//===========================================================================//
+std::atomic<nyra::Profiler*> registeredProfiler(&fallbackProfiler);
+}
+
+namespace nyra
+{
+//===========================================================================//
+Profiler::ThreadBuffer::ThreadBuffer(size_t threadId) :
+    threadId(threadId),
+    next(0)
+{
+    events.reserve(EVENTS_PER_THREAD);
+}
+
+//===========================================================================//
+Profiler::Profiler() :
+    mId(nextProfilerId++),
+    mEpoch(now())
+{
+}
+
+//===========================================================================//
+Profiler::~Profiler()
+{
+}
+
+//===========================================================================//
+void Profiler::registerProfiler(Profiler* profiler)
+{
+    registeredProfiler = profiler ? profiler : &fallbackProfiler;
+}
+
+//===========================================================================//
+Profiler& Profiler::getRegisteredProfiler()
+{
+    return *registeredProfiler;
+}
+
+//===========================================================================//
+int64_t Profiler::now()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//===========================================================================//
+Profiler::ThreadBuffer& Profiler::getThreadBuffer()
+{
+    // Caches the buffer of the last profiler used on this thread
+    static thread_local uint64_t owner = 0;
+    static thread_local ThreadBuffer* buffer = nullptr;
+    if (owner != mId)
+    {
+        // A thread that switches between profilers keeps one buffer in each
+        std::lock_guard<std::mutex> lock(mMutex);
+        ThreadBuffer*& threadBuffer =
+                mThreadBuffers[std::this_thread::get_id()];
+        if (!threadBuffer)
+        {
+            mBuffers.push_back(std::unique_ptr<ThreadBuffer>(
+                    new ThreadBuffer(mBuffers.size())));
+            threadBuffer = mBuffers.back().get();
+        }
+        buffer = threadBuffer;
+        owner = mId;
+    }
+    return *buffer;
+}
+
+//===========================================================================//
+void Profiler::record(const char* phase,
+                      int64_t start,
+                      int64_t end)
+{
+    ThreadBuffer& buffer = getThreadBuffer();
+    const Event event = {phase, start, end - start};
+
+    // This lock is only contended while stats are being read
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.events.size() < EVENTS_PER_THREAD)
+    {
+        buffer.events.push_back(event);
+    }
+    else
+    {
+        buffer.events[buffer.next] = event;
+    }
+    buffer.next = (buffer.next + 1) % EVENTS_PER_THREAD;
+}
+
+//===========================================================================//
+ProfileStats Profiler::getStats(const std::string& phase) const
+{
+    std::vector<int64_t> durations;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (const auto& buffer : mBuffers)
+        {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            for (const Event& event : buffer->events)
+            {
+                if (phase == event.phase)
+                {
+                    durations.push_back(event.duration);
+                }
+            }
+        }
+    }
+
+    ProfileStats stats;
+    if (durations.empty())
+    {
+        return stats;
+    }
+
+    std::sort(durations.begin(), durations.end());
+    double total = 0.0;
+    for (int64_t duration : durations)
+    {
+        total += duration;
+    }
+
+    const size_t p99Index = static_cast<size_t>(
+            std::ceil(0.99 * durations.size())) - 1;
+    stats.count = durations.size();
+    stats.minimum = durations.front() / 1000.0;
+    stats.average = (total / durations.size()) / 1000.0;
+    stats.maximum = durations.back() / 1000.0;
+    stats.p99 = durations[p99Index] / 1000.0;
+    return stats;
+}
+
+//===========================================================================//
+std::vector<std::string> Profiler::getPhases() const
+{
+    std::set<std::string> phases;
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (const auto& buffer : mBuffers)
+    {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        for (const Event& event : buffer->events)
+        {
+            phases.insert(event.phase);
+        }
+    }
+    return std::vector<std::string>(phases.begin(), phases.end());
+}
+
+//===========================================================================//
+void Profiler::dumpTrace(const std::string& pathname) const
+{
+    std::ofstream file(pathname);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Unable to open trace file: " + pathname);
+    }
+
+    file << "{\"traceEvents\":[";
+    bool first = true;
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (const auto& buffer : mBuffers)
+    {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+
+        // Once the ring has wrapped the oldest event is the next to write
+        const size_t count = buffer->events.size();
+        const size_t begin = count < EVENTS_PER_THREAD ? 0 : buffer->next;
+        for (size_t ii = 0; ii < count; ++ii)
+        {
+            const Event& event = buffer->events[(begin + ii) % count];
+            file << (first ? "\n" : ",\n")
+                 << "{\"name\":\"" << event.phase << "\","
+                 << "\"cat\":\"nyra\",\"ph\":\"X\","
+                 << "\"ts\":" << (event.start - mEpoch) << ","
+                 << "\"dur\":" << event.duration << ","
+                 << "\"pid\":0,\"tid\":" << buffer->threadId << "}";
+            first = false;
+        }
+    }
+    file << "\n]}\n";
+}
+
+//===========================================================================//
+void Profiler::clear()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (const auto& buffer : mBuffers)
+    {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->events.clear();
+        buffer->next = 0;
+    }
+}
+}
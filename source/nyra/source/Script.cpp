@@ -31,7 +31,30 @@ namespace nyra
 //===========================================================================//
 Script::Script(const std::string& moduleName,
                const std::string& className,
-               void* data)
+               size_t data) :
+    mModule(importModule(moduleName)),
+    mIndex(0)
+{
+    if (!className.empty())
+    {
+        mClass = getClass(mModule, className);
+    }
+    createInstance(data);
+}
+
+//===========================================================================//
+Script::Script(const AutoPy& module,
+               const AutoPy& classObject,
+               size_t data) :
+    mModule(module),
+    mClass(classObject),
+    mIndex(0)
+{
+    createInstance(data);
+}
+
+//===========================================================================//
+AutoPy Script::importModule(const std::string& moduleName)
 {
     const AutoPy pyModuleName(PyString_FromString(moduleName.c_str()));
     if (!pyModuleName.get())
@@ -39,33 +62,46 @@ Script::Script(const std::string& moduleName,
         throw std::runtime_error(
                 "Unable to create Python string: " + moduleName);
     }
-    mModule.reset(PyImport_Import(pyModuleName.get()));
-    if (!mModule.get())
+    AutoPy module(PyImport_Import(pyModuleName.get()));
+    if (!module.get())
     {
         throw std::runtime_error("Unable to open Python module: " + moduleName);
     }
+    return module;
+}
 
-    if (!className.empty())
+//===========================================================================//
+AutoPy Script::getClass(const AutoPy& module,
+                        const std::string& className)
+{
+    AutoPy classObject(PyObject_GetAttrString(module.get(), className.c_str()));
+    if (!classObject.get())
     {
-        mClass.reset(PyObject_GetAttrString(mModule.get(), className.c_str()));
-        if (!mClass.get())
-        {
-            throw std::runtime_error(
-                    "Unable to open class module: " + className);
-        }
+        throw std::runtime_error(
+                "Unable to open class module: " + className);
+    }
+    return classObject;
+}
 
+//===========================================================================//
+void Script::createInstance(size_t data)
+{
+    if (mClass.get())
+    {
         AutoPy argList(PyTuple_New(0));
         mInstance.reset(PyObject_CallObject(mClass.get(), argList.get()));
         if (!mInstance.get())
         {
+            const AutoPy name(PyObject_Str(mClass.get()));
             throw std::runtime_error("Unable to create instace of: " +
-                    moduleName + "::" + className);
+                    std::string(name.get() ? PyString_AsString(name.get()) :
+                                             "unknown class"));
         }
     }
 
     // Call the set_data method by default to initialize the instance.
     addMethod("set_data", "_set_data");
-    call<size_t>("set_data", reinterpret_cast<size_t>(data));
+    call<size_t>("set_data", data);
 }
 
 //===========================================================================//
@@ -148,4 +184,14 @@ void Script::addParam(const AutoPy& argList,
                     PyInt_FromSize_t(value));
 }
 
+//===========================================================================//
+template <>
+void Script::addParam(const AutoPy& argList,
+                      size_t pos,
+                      PyObject* value)
+{
+    // The tuple steals the reference so the caller gives up ownership
+    PyTuple_SetItem(argList.get(), pos, value);
+}
+
 }
@@ -27,7 +27,9 @@
 namespace nyra
 {
 //===========================================================================//
-ScriptEngine::ScriptEngine(void* engine)
+ScriptEngine::ScriptEngine(void* engine, Arena& arena) :
+    mScriptPool(arena),
+    mActiveScripts(0)
 {
     // Make sure Python is initialized first.
     if (!Py_IsInitialized())
@@ -40,7 +42,8 @@ ScriptEngine::ScriptEngine(void* engine)
         throw std::runtime_error("Python was reinitialized.");
     }
 
-    mEngineScript.reset(new Script("nyra", "", engine));
+    mEngineScript.reset(new Script("nyra", "",
+                                   reinterpret_cast<size_t>(engine)));
 }
 
 //===========================================================================//
@@ -56,34 +59,101 @@ ScriptEngine::~ScriptEngine()
 //===========================================================================//
 void ScriptEngine::update(double deltaTime)
 {
-    for (auto& script : mScripts)
+    // Scripts can be spawned while this runs so indices are used
+    for (size_t ii = 0; ii < mActiveScripts; ++ii)
     {
-        script->call<double>("update", deltaTime);
+        mScripts[ii]->call<double>("update", deltaTime);
     }
 }
 
 //===========================================================================//
 void ScriptEngine::init()
 {
-    for (auto& script : mScripts)
+    for (size_t ii = 0; ii < mActiveScripts; ++ii)
     {
-        script->call("init");
+        mScripts[ii]->call("init");
     }
 }
 
 //===========================================================================//
 void ScriptEngine::reset()
 {
+    // Scripts hold Python references so they are destructed one by one.
+    // Their memory is given back when the arena is reset.
+    for (Script* script : mScripts)
+    {
+        mScriptPool.destroy(script);
+    }
     mScripts.clear();
+    mScriptPool.reset();
+    mActiveScripts = 0;
+    mClasses.clear();
 }
 
 //===========================================================================//
 Script* ScriptEngine::addScript(const std::string& moduleName,
                                 const std::string& className,
-                                void* data)
+                                size_t data)
 {
-    Script* script = new Script(moduleName, className, data);
-    mScripts.push_back(std::unique_ptr<Script>(script));
+    // Importing and finding the class is only done once for each class
+    const std::string key(moduleName + ":" + className);
+    auto iter = mClasses.find(key);
+    if (iter == mClasses.end())
+    {
+        const AutoPy module(Script::importModule(moduleName));
+        const AutoPy classObject(className.empty() ?
+                AutoPy() : Script::getClass(module, className));
+        iter = mClasses.insert(std::make_pair(
+                key, std::make_pair(module, classObject))).first;
+    }
+
+    Script* script = mScriptPool.create(iter->second.first,
+                                        iter->second.second,
+                                        data);
+    script->setIndex(mScripts.size());
+    mScripts.push_back(script);
+    setActive(*script, true);
     return script;
 }
+
+//===========================================================================//
+void ScriptEngine::removeScript(Script& script)
+{
+    // Swap with the last script to keep the list dense
+    setActive(script, false);
+    swapScripts(script.getIndex(), mScripts.size() - 1);
+    mScripts.pop_back();
+    mScriptPool.destroy(&script);
+}
+
+//===========================================================================//
+void ScriptEngine::setActive(Script& script, bool active)
+{
+    const size_t index = script.getIndex();
+    if ((index < mActiveScripts) == active)
+    {
+        return;
+    }
+
+    // Swap across the boundary between active and inactive scripts. Only
+    // inactive scripts move when activating.
+    if (active)
+    {
+        swapScripts(index, mActiveScripts);
+        ++mActiveScripts;
+    }
+    else
+    {
+        --mActiveScripts;
+        swapScripts(index, mActiveScripts);
+    }
+}
+
+//===========================================================================//
+void ScriptEngine::swapScripts(size_t first, size_t second)
+{
+    std::swap(mScripts[first], mScripts[second]);
+    mScripts[first]->setIndex(first);
+    mScripts[second]->setIndex(second);
+}
 }
\ No newline at end of file
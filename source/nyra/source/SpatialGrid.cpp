@@ -0,0 +1,175 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#include <nyra/SpatialGrid.h>
+#include <algorithm>
+#include <cmath>
+
+namespace nyra
+{
+//===========================================================================//
+SpatialGrid::SpatialGrid(float cellSize) :
+    mCellSize(cellSize),
+    mQuery(0)
+{
+}
+
+//===========================================================================//
+void SpatialGrid::update(size_t id, const sf::FloatRect& bounds)
+{
+    if (id >= mEntries.size())
+    {
+        Entry empty;
+        empty.inserted = false;
+        empty.query = 0;
+        mEntries.resize(id + 1, empty);
+    }
+
+    Entry& entry = mEntries[id];
+    const int left = toCell(bounds.left);
+    const int top = toCell(bounds.top);
+    const int right = toCell(bounds.left + bounds.width);
+    const int bottom = toCell(bounds.top + bounds.height);
+    entry.bounds = bounds;
+
+    // Most moves stay within the same cells
+    if (entry.inserted && entry.left == left && entry.top == top &&
+        entry.right == right && entry.bottom == bottom)
+    {
+        return;
+    }
+
+    if (entry.inserted)
+    {
+        removeFromCells(id, entry);
+    }
+    entry.inserted = true;
+    entry.left = left;
+    entry.top = top;
+    entry.right = right;
+    entry.bottom = bottom;
+    addToCells(id, entry);
+}
+
+//===========================================================================//
+void SpatialGrid::remove(size_t id)
+{
+    if (id >= mEntries.size() || !mEntries[id].inserted)
+    {
+        return;
+    }
+    removeFromCells(id, mEntries[id]);
+    mEntries[id].inserted = false;
+}
+
+//===========================================================================//
+void SpatialGrid::clear()
+{
+    mCells.clear();
+    mEntries.clear();
+    mQuery = 0;
+}
+
+//===========================================================================//
+void SpatialGrid::query(const sf::FloatRect& area,
+                        std::vector<size_t>& results)
+{
+    // Objects that span several cells are only reported the first time
+    ++mQuery;
+    const int left = toCell(area.left);
+    const int top = toCell(area.top);
+    const int right = toCell(area.left + area.width);
+    const int bottom = toCell(area.top + area.height);
+    for (int y = top; y <= bottom; ++y)
+    {
+        for (int x = left; x <= right; ++x)
+        {
+            auto cell = mCells.find(getKey(x, y));
+            if (cell == mCells.end())
+            {
+                continue;
+            }
+
+            for (size_t id : cell->second)
+            {
+                Entry& entry = mEntries[id];
+                if (entry.query != mQuery)
+                {
+                    entry.query = mQuery;
+                    if (entry.bounds.intersects(area))
+                    {
+                        results.push_back(id);
+                    }
+                }
+            }
+        }
+    }
+}
+
+//===========================================================================//
+int SpatialGrid::toCell(float value) const
+{
+    return static_cast<int>(std::floor(value / mCellSize));
+}
+
+//===========================================================================//
+uint64_t SpatialGrid::getKey(int x, int y)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) |
+           static_cast<uint32_t>(y);
+}
+
+//===========================================================================//
+void SpatialGrid::addToCells(size_t id, const Entry& entry)
+{
+    for (int y = entry.top; y <= entry.bottom; ++y)
+    {
+        for (int x = entry.left; x <= entry.right; ++x)
+        {
+            mCells[getKey(x, y)].push_back(id);
+        }
+    }
+}
+
+//===========================================================================//
+void SpatialGrid::removeFromCells(size_t id, const Entry& entry)
+{
+    for (int y = entry.top; y <= entry.bottom; ++y)
+    {
+        for (int x = entry.left; x <= entry.right; ++x)
+        {
+            auto cell = mCells.find(getKey(x, y));
+            std::vector<size_t>& ids = cell->second;
+            auto iter = std::find(ids.begin(), ids.end(), id);
+            *iter = ids.back();
+            ids.pop_back();
+
+            // Scrolling maps would otherwise keep every cell ever visited
+            if (ids.empty())
+            {
+                mCells.erase(cell);
+            }
+        }
+    }
+}
+}
@@ -22,20 +22,18 @@
  * IN THE SOFTWARE.
  */
 #include <nyra/Sprite.h>
-#include <nyra/Logger.h>
 
 namespace nyra
 {
-Sprite::Sprite(const std::string& pathname)
+//===========================================================================//
+Sprite::Sprite(const TextureRegion& region) :
+    mDirty(true),
+    mVisible(true),
+    mDirtyList(nullptr),
+    mIndex(0),
+    mTexture(region.texture)
 {
-    Logger::debug("Loading sprite: " + pathname);
-
-    // TODO: Replace this with managed shared memory.
-    mTexture.reset(new sf::Texture());
-    if (!mTexture->loadFromFile(pathname))
-    {
-        throw std::runtime_error("Unable to load texture: " + pathname);
-    }
     mSprite.setTexture(*mTexture);
+    mSprite.setTextureRect(region.rect);
+}
 }
-}
\ No newline at end of file
@@ -22,57 +22,90 @@
  * IN THE SOFTWARE.
  */
 #include <nyra/SwigActor.h>
-#include <iostream>
+#include <nyra/SwigEngine.h>
+#include <nyra/Engine.h>
+#include <stdexcept>
 
 namespace nyra
 {
 //===========================================================================//
 SwigActor::SwigActor() :
-    mData(nullptr)
+    mData(INVALID_ACTOR)
 {
 }
 
 //===========================================================================//
-void SwigActor::_set_data(size_t data)
+void SwigActor::_set_data(size_t handle)
 {
-    if (data == 0)
+    if (handle == INVALID_ACTOR)
     {
         throw std::runtime_error("Attempting to create a void actor.");
     }
-    mData = reinterpret_cast<Actor*>(data);
+    mData = handle;
 }
 
 //===========================================================================//
 size_t SwigActor::_get_data() const
 {
-    if (mData == nullptr)
+    if (mData == INVALID_ACTOR)
     {
         throw std::runtime_error("Attempting to retreive a null actor.");
     }
-    return reinterpret_cast<size_t>(mData);
+    return mData;
 }
 
 //===========================================================================//
 void SwigActor::_set_position(const Vector2& vector) const
 {
-    mData->setPosition(vector);
+    _get_engine().getActor(mData).setPosition(vector);
 }
 
 //===========================================================================//
 Vector2 SwigActor::_get_position() const
 {
-    return mData->getPosition();
+    return _get_engine().getActor(mData).getPosition();
 }
 
 //===========================================================================//
 Vector2 SwigActor::_get_velocity() const
 {
-    return mData->getVelocity();
+    return _get_engine().getActor(mData).getVelocity();
+}
+
+//===========================================================================//
+void SwigActor::_attach(const SwigActor& parent,
+                        const Vector2& offset,
+                        double rotation) const
+{
+    Engine& engine = _get_engine();
+    engine.getActor(mData).attach(engine.getActor(parent._get_data()),
+                                  offset,
+                                  rotation);
+}
+
+//===========================================================================//
+void SwigActor::detach() const
+{
+    _get_engine().getActor(mData).detach();
+}
+
+//===========================================================================//
+void SwigActor::destroy() const
+{
+    Engine& engine = _get_engine();
+    engine.destroyActor(engine.getActor(mData));
+}
+
+//===========================================================================//
+void SwigActor::despawn() const
+{
+    Engine& engine = _get_engine();
+    engine.despawn(engine.getActor(mData));
 }
 
 //===========================================================================//
 void SwigActor::_apply_force(const Vector2& force) const
 {
-    mData->applyForce(force);
+    _get_engine().getActor(mData).applyForce(force);
 }
 }
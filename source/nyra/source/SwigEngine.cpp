@@ -27,6 +27,61 @@
 namespace
 {
 static nyra::Engine* engine = nullptr;
+
+//===========================================================================//
+const std::vector<nyra::ActorHandle>& getQueryResults(size_t query)
+{
+    // The index comes from a script so it is checked before it is used
+    if (query >= engine->getQueryCount())
+    {
+        throw std::runtime_error(
+                "Invalid query: " + std::to_string(query));
+    }
+    return engine->getQueryResults(query);
+}
+
+//===========================================================================//
+std::vector<nyra::Vector2> toPoints(const std::vector<double>& coordinates)
+{
+    if (coordinates.size() % 2 != 0)
+    {
+        throw std::runtime_error(
+                "Positions must be pairs of x and y values.");
+    }
+
+    std::vector<nyra::Vector2> points(coordinates.size() / 2);
+    for (size_t ii = 0; ii < points.size(); ++ii)
+    {
+        points[ii] = nyra::Vector2(coordinates[ii * 2],
+                                   coordinates[ii * 2 + 1]);
+    }
+    return points;
+}
+
+//===========================================================================//
+nyra::PhysicsHits toPhysicsHits(const std::vector<nyra::RayHit>& hits)
+{
+    nyra::PhysicsHits results;
+    results.actors.resize(hits.size(), nyra::INVALID_ACTOR);
+    results.values.resize(hits.size() * 5, 0.0);
+    for (size_t ii = 0; ii < hits.size(); ++ii)
+    {
+        double* values = &results.values[ii * 5];
+        if (!hits[ii].hit)
+        {
+            values[4] = -1.0;
+            continue;
+        }
+
+        results.actors[ii] = hits[ii].actor;
+        values[0] = hits[ii].point.x;
+        values[1] = hits[ii].point.y;
+        values[2] = hits[ii].normal.x;
+        values[3] = hits[ii].normal.y;
+        values[4] = hits[ii].fraction;
+    }
+    return results;
+}
 }
 
 namespace nyra
@@ -41,6 +96,16 @@ void _set_data(size_t address)
     engine = reinterpret_cast<Engine*>(address);
 }
 
+//===========================================================================//
+Engine& _get_engine()
+{
+    if (!engine)
+    {
+        throw std::runtime_error("The engine has not been set.");
+    }
+    return *engine;
+}
+
 //===========================================================================//
 void _register_input(const std::string& name,
                      const std::vector<size_t>& inputs)
@@ -100,7 +165,181 @@ void log(const std::string& message)
 void _camera_track(size_t actor,
                    const Vector2& offset)
 {
-    engine->getCamera().track(
-            *reinterpret_cast<const Actor*>(actor), offset, 0.0);
+    const Actor target = engine->getActor(actor);
+    if (!target.isValid())
+    {
+        throw std::runtime_error("Attempting to track a destroyed actor.");
+    }
+    engine->getCamera().track(target, offset, 0.0);
+}
+
+//===========================================================================//
+size_t _spawn(const std::string& filename,
+              const Vector2& position)
+{
+    return engine->spawn(filename, position).getHandle();
+}
+
+//===========================================================================//
+std::vector<size_t> _spawn_many(const std::string& filename,
+                                const std::vector<double>& coordinates,
+                                const std::vector<double>& rotations)
+{
+    std::vector<ActorHandle> handles;
+    engine->addActors(filename, toPoints(coordinates), rotations, handles);
+    engine->initActors(handles);
+    return std::vector<size_t>(handles.begin(), handles.end());
+}
+
+//===========================================================================//
+void prewarm(const std::string& filename,
+             size_t count)
+{
+    engine->prewarm(filename, count);
+}
+
+//===========================================================================//
+size_t _add_query(const std::vector<std::string>& components,
+                  const std::vector<std::string>& tags)
+{
+    ComponentMask mask = 0;
+    for (const std::string& component : components)
+    {
+        if (component == "sprite")
+        {
+            mask |= ComponentStore::SPRITE_MASK;
+        }
+        else if (component == "physics")
+        {
+            mask |= ComponentStore::PHYSICS_MASK;
+        }
+        else if (component == "script")
+        {
+            mask |= ComponentStore::SCRIPT_MASK;
+        }
+        else
+        {
+            throw std::runtime_error("Invalid component: " + component);
+        }
+    }
+    return engine->addQuery(mask, tags);
+}
+
+//===========================================================================//
+std::vector<size_t> _query_results(size_t query)
+{
+    const std::vector<ActorHandle>& results = getQueryResults(query);
+    return std::vector<size_t>(results.begin(), results.end());
+}
+
+//===========================================================================//
+size_t _query_size(size_t query)
+{
+    return getQueryResults(query).size();
+}
+
+//===========================================================================//
+void _post_event(const std::string& name,
+                 size_t target,
+                 size_t source,
+                 double value,
+                 const Vector2& position)
+{
+    EventBus& events = engine->getEvents();
+    Event event;
+    event.type = events.getType(name);
+    event.target = target;
+    event.source = source;
+    event.value = value;
+    event.position = position;
+    events.post(event);
+}
+
+//===========================================================================//
+void _broadcast_event(const std::string& name,
+                      size_t query,
+                      size_t source,
+                      double value,
+                      const Vector2& position)
+{
+    EventBus& events = engine->getEvents();
+    Event event;
+    event.type = events.getType(name);
+    event.target = INVALID_ACTOR;
+    event.source = source;
+    event.value = value;
+    event.position = position;
+    events.post(event, getQueryResults(query));
+}
+
+//===========================================================================//
+ProfileStats _profile_stats(const std::string& phase)
+{
+    return engine->getProfiler().getStats(phase);
+}
+
+//===========================================================================//
+std::vector<std::string> _profile_phases()
+{
+    return engine->getProfiler().getPhases();
+}
+
+//===========================================================================//
+void dump_profile(const std::string& pathname)
+{
+    engine->getProfiler().dumpTrace(pathname);
+}
+
+//===========================================================================//
+PhysicsSettings get_physics_settings()
+{
+    return engine->getPhysics().getSettings();
+}
+
+//===========================================================================//
+void set_physics_settings(const PhysicsSettings& settings)
+{
+    engine->getPhysics().setSettings(settings);
+}
+
+//===========================================================================//
+PhysicsStats physics_stats()
+{
+    return engine->getPhysics().getStats();
+}
+
+//===========================================================================//
+PhysicsHits _ray_cast_many(const std::vector<double>& coordinates)
+{
+    std::vector<RayHit> hits;
+    engine->getPhysics().rayCast(toPoints(coordinates), hits);
+    return toPhysicsHits(hits);
+}
+
+//===========================================================================//
+PhysicsHits _circle_cast_many(const std::vector<double>& coordinates,
+                              const std::vector<double>& radii)
+{
+    std::vector<RayHit> hits;
+    engine->getPhysics().circleCast(toPoints(coordinates), radii, hits);
+    return toPhysicsHits(hits);
+}
+
+//===========================================================================//
+PhysicsOverlaps _query_box_many(const std::vector<double>& coordinates)
+{
+    std::vector<ActorHandle> actors;
+    PhysicsOverlaps overlaps;
+    engine->getPhysics().queryBox(toPoints(coordinates),
+                                  actors,
+                                  overlaps.offsets);
+    overlaps.actors.assign(actors.begin(), actors.end());
+    return overlaps;
+}
+
+//===========================================================================//
+size_t arena_high_water_mark()
+{
+    return engine->getArena().getHighWaterMark();
 }
 }
@@ -0,0 +1,164 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#include <nyra/TextureManager.h>
+#include <nyra/FileSystem.h>
+#include <nyra/JSONAtlas.h>
+#include <nyra/Logger.h>
+#include <stdexcept>
+
+namespace
+{
+//===========================================================================//
+static const size_t BYTES_PER_PIXEL = 4;
+
+//===========================================================================//
+std::string getDirectory(const std::string& pathname)
+{
+    const size_t slash = pathname.rfind('/');
+    return slash == std::string::npos ? "." : pathname.substr(0, slash);
+}
+
+//===========================================================================//
+std::string makeKey(const std::string& pathname)
+{
+    // Only the directory has to exist. Packed images may have been
+    // removed from disk once they are in an atlas.
+    const size_t slash = pathname.rfind('/');
+    const std::string filename = slash == std::string::npos ?
+            pathname : pathname.substr(slash + 1);
+    return nyra::canonicalPath(getDirectory(pathname)) + "/" + filename;
+}
+}
+
+namespace nyra
+{
+//===========================================================================//
+TextureManager::TextureManager(bool loadTextures) :
+    mLoadTextures(loadTextures),
+    mHits(0),
+    mMisses(0),
+    mMemoryUsage(0)
+{
+}
+
+//===========================================================================//
+TextureRegion TextureManager::get(const std::string& pathname)
+{
+    const std::string key = makeKey(pathname);
+    auto atlas = mAtlas.find(key);
+    if (atlas != mAtlas.end())
+    {
+        ++mHits;
+        return atlas->second;
+    }
+
+    if (mTextures.count(key))
+    {
+        ++mHits;
+    }
+    const Entry& entry = load(key);
+
+    TextureRegion region;
+    region.texture = entry.texture;
+    region.rect = sf::IntRect(0, 0, entry.size.x, entry.size.y);
+    return region;
+}
+
+//===========================================================================//
+void TextureManager::loadAtlas(const std::string& pathname)
+{
+    Logger::info("Loading texture atlas: " + pathname);
+    const std::string directory = getDirectory(pathname);
+    const JSONAtlas atlas(pathname);
+    for (const auto& page : atlas.pages)
+    {
+        const Entry& entry = load(makeKey(directory + "/" + page.filename));
+        for (const auto& texture : page.textures)
+        {
+            TextureRegion region;
+            region.texture = entry.texture;
+            region.rect = sf::IntRect(
+                    static_cast<int>(texture.position.x),
+                    static_cast<int>(texture.position.y),
+                    static_cast<int>(texture.size.x),
+                    static_cast<int>(texture.size.y));
+            mAtlas[makeKey(directory + "/" + texture.filename)] = region;
+        }
+    }
+}
+
+//===========================================================================//
+const TextureManager::Entry& TextureManager::load(const std::string& key)
+{
+    auto iter = mTextures.find(key);
+    if (iter != mTextures.end())
+    {
+        return iter->second;
+    }
+
+    ++mMisses;
+    Logger::debug("Loading texture: " + key);
+
+    Entry entry;
+    std::shared_ptr<sf::Texture> texture(new sf::Texture());
+    if (mLoadTextures)
+    {
+        if (!texture->loadFromFile(key))
+        {
+            throw std::runtime_error("Unable to load texture: " + key);
+        }
+        entry.size = texture->getSize();
+    }
+    else
+    {
+        sf::Image image;
+        if (!image.loadFromFile(key))
+        {
+            throw std::runtime_error("Unable to load image: " + key);
+        }
+        entry.size = image.getSize();
+    }
+    entry.texture = texture;
+    mMemoryUsage += entry.size.x * entry.size.y * BYTES_PER_PIXEL;
+    return mTextures.insert(std::make_pair(key, entry)).first->second;
+}
+
+//===========================================================================//
+void TextureManager::purge()
+{
+    for (auto iter = mTextures.begin(); iter != mTextures.end();)
+    {
+        if (iter->second.texture.use_count() == 1)
+        {
+            const sf::Vector2u& size = iter->second.size;
+            mMemoryUsage -= size.x * size.y * BYTES_PER_PIXEL;
+            iter = mTextures.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+}
+}
@@ -0,0 +1,162 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 Clyde Stanfield
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+#include <nyra/WorkerPool.h>
+
+namespace
+{
+//===========================================================================//
+std::exception_ptr runPart(const std::function<void(size_t)>& task,
+                           size_t index)
+{
+    // An exception escaping a worker thread would terminate the program,
+    // so it is carried back to the caller instead
+    try
+    {
+        task(index);
+    }
+    catch (...)
+    {
+        return std::current_exception();
+    }
+    return std::exception_ptr();
+}
+}
+
+namespace nyra
+{
+//===========================================================================//
+WorkerPool::WorkerPool(size_t threads) :
+    mTask(nullptr),
+    mCount(0),
+    mNext(0),
+    mRemaining(0),
+    mStopping(false)
+{
+    mThreads.reserve(threads);
+    for (size_t ii = 0; ii < threads; ++ii)
+    {
+        mThreads.push_back(std::thread(&WorkerPool::workLoop, this));
+    }
+}
+
+//===========================================================================//
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mStart.notify_all();
+    for (std::thread& thread : mThreads)
+    {
+        thread.join();
+    }
+}
+
+//===========================================================================//
+void WorkerPool::run(size_t count, const std::function<void(size_t)>& task)
+{
+    // Waking threads costs more than a single part
+    if (mThreads.empty() || count < 2)
+    {
+        for (size_t ii = 0; ii < count; ++ii)
+        {
+            task(ii);
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mTask = &task;
+    mCount = count;
+    mNext = 0;
+    mRemaining = count;
+    lock.unlock();
+    mStart.notify_all();
+
+    // Parts are handed out one at a time under the lock. They are large
+    // enough that the lock is never the bottleneck.
+    lock.lock();
+    while (mNext < mCount)
+    {
+        const size_t index = mNext++;
+        lock.unlock();
+        const std::exception_ptr error = runPart(task, index);
+        lock.lock();
+        if (error && !mError)
+        {
+            mError = error;
+        }
+        --mRemaining;
+    }
+    mDone.wait(lock, [this]
+    {
+        return mRemaining == 0;
+    });
+
+    // Workers check for parts left before touching the task, so the job
+    // is closed before the task goes out of scope
+    mTask = nullptr;
+    mCount = 0;
+    mNext = 0;
+
+    if (mError)
+    {
+        std::exception_ptr error;
+        error.swap(mError);
+        std::rethrow_exception(error);
+    }
+}
+
+//===========================================================================//
+void WorkerPool::workLoop()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true)
+    {
+        mStart.wait(lock, [this]
+        {
+            return mStopping || mNext < mCount;
+        });
+        if (mStopping)
+        {
+            return;
+        }
+
+        const size_t index = mNext++;
+        const std::function<void(size_t)>& task = *mTask;
+        lock.unlock();
+        const std::exception_ptr error = runPart(task, index);
+        lock.lock();
+        if (error && !mError)
+        {
+            mError = error;
+        }
+        if (--mRemaining == 0)
+        {
+            mDone.notify_all();
+        }
+    }
+}
+}